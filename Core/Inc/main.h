@@ -94,6 +94,18 @@ void Error_Handler(void);
 #define D10_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
+/* LCD D0..D3 of the 8-bit bus on A0..A3, configured by displayInit() */
+#define A0_Pin GPIO_PIN_0
+#define A0_GPIO_Port GPIOA
+#define A1_Pin GPIO_PIN_1
+#define A1_GPIO_Port GPIOA
+#define A2_Pin GPIO_PIN_4
+#define A2_GPIO_Port GPIOA
+#define A3_Pin GPIO_PIN_0
+#define A3_GPIO_Port GPIOB
+/* LCD RW on A4, configured by displayInit() in busy-flag mode */
+#define A4_Pin GPIO_PIN_1
+#define A4_GPIO_Port GPIOC
 
 /* USER CODE END Private defines */
 
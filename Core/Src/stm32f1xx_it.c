@@ -22,6 +22,9 @@
 #include "stm32f1xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "display.h"
+#include "logger.h"
+#include "task_sensor.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -206,6 +209,7 @@ void SysTick_Handler(void)
 void EXTI15_10_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_10_IRQn 0 */
+  task_sensor_exti_irq_handler();
 
   /* USER CODE END EXTI15_10_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(B1_Pin);
@@ -215,5 +219,52 @@ void EXTI15_10_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (button edges).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  task_sensor_exti_irq_handler();
+}
+
+/**
+  * @brief This function handles TIM4 global interrupt (display write engine).
+  */
+void TIM4_IRQHandler(void)
+{
+  displayTimerIrqHandler();
+}
+
+/**
+  * @brief This function handles USART2 global interrupt (logger drain).
+  */
+void USART2_IRQHandler(void)
+{
+  logger_uart_irq_handler();
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt (display I2C transport).
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  displayI2cEventIrqHandler();
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt (display I2C transport).
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  displayI2cErrorIrqHandler();
+}
+
+/**
+  * @brief This function handles DMA1 channel6 global interrupt (I2C1 TX).
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+  displayI2cDmaIrqHandler();
+}
 
 /* USER CODE END 1 */
@@ -44,6 +44,7 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "dwt.h"
 
 /********************** macros ***********************************************/
 #define TEST_0 (0)
@@ -52,11 +53,29 @@ extern "C" {
 
 #define TEST_X (TEST_0)
 
+#define TASK_X_HIST_QTY	(12)		/* Multiple of 4 (dump layout) */
+
 /********************** typedef **********************************************/
+typedef struct {
+    uint32_t WCET;			// Worst-case execution time (microseconds)
+    uint32_t BCET;			// Best-case execution time (microseconds)
+    uint32_t cnt;			// Measured executions
+    uint64_t sum;			// Sum of execution times (microseconds)
+    uint32_t hist[TASK_X_HIST_QTY];	// Execution times, log2 bins (microseconds)
+    uint32_t jitter_max;	// Worst release delay from the SysTick boundary (microseconds)
+    uint64_t jitter_sum;	// Sum of release delays (microseconds)
+    dwt_region_t region;	// Execution times (cycles)
+    uint32_t deadline_miss;	// Executions completed after release + deadline
+    uint32_t skip_cnt;		// Releases dropped by the overrun policy
+} task_dta_t;
 
 /********************** external data declaration ****************************/
 extern uint32_t g_app_cnt;
 extern uint32_t g_app_runtime_us;
+extern uint32_t g_app_overrun_cnt;
+extern uint32_t g_app_skip_cnt;
+extern uint32_t g_app_sleep_cnt;
+extern uint32_t g_app_tickless_cnt;
 
 extern volatile uint32_t g_app_tick_cnt;
 
@@ -64,6 +83,12 @@ extern volatile uint32_t g_app_tick_cnt;
 extern void app_init(void);
 extern void app_update(void);
 
+extern uint32_t app_task_qty(void);
+extern const task_dta_t *app_task_dta_get(uint32_t index);
+extern void app_stats_reset(void);
+extern void app_stats_dump(void);
+extern uint32_t app_idle_permille(void);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
@@ -82,8 +82,10 @@ extern "C" {
 #define BTN_NEX_PRESSED	GPIO_PIN_RESET
 #define BTN_NEX_HOVER	GPIO_PIN_SET
 
-#define BTN_ESC_PIN		D12_Pin
-#define BTN_ESC_PORT	D12_GPIO_Port
+/* Each button needs an EXTI line of its own to wake task_sensor: D12 (PA6)
+ * shares line 6 with ENT on D10 (PB6), so ESC is on D2 (PA10, line 10) */
+#define BTN_ESC_PIN		D2_Pin
+#define BTN_ESC_PORT	D2_GPIO_Port
 #define BTN_ESC_PRESSED	GPIO_PIN_RESET
 #define BTN_ESC_HOVER	GPIO_PIN_SET
 
@@ -92,6 +94,46 @@ extern "C" {
 #define LED_A_ON		GPIO_PIN_SET
 #define LED_A_OFF		GPIO_PIN_RESET
 
+/* HD44780 LCD, D0..D3 are only wired for the 8-bit bus */
+#define DISPLAY_D0_PIN	A0_Pin
+#define DISPLAY_D0_PORT	A0_GPIO_Port
+#define DISPLAY_D1_PIN	A1_Pin
+#define DISPLAY_D1_PORT	A1_GPIO_Port
+#define DISPLAY_D2_PIN	A2_Pin
+#define DISPLAY_D2_PORT	A2_GPIO_Port
+#define DISPLAY_D3_PIN	A3_Pin
+#define DISPLAY_D3_PORT	A3_GPIO_Port
+#define DISPLAY_D4_PIN	D4_Pin
+#define DISPLAY_D4_PORT	D4_GPIO_Port
+#define DISPLAY_D5_PIN	D5_Pin
+#define DISPLAY_D5_PORT	D5_GPIO_Port
+#define DISPLAY_D6_PIN	D6_Pin
+#define DISPLAY_D6_PORT	D6_GPIO_Port
+#define DISPLAY_D7_PIN	D7_Pin
+#define DISPLAY_D7_PORT	D7_GPIO_Port
+#define DISPLAY_RS_PIN	D8_Pin
+#define DISPLAY_RS_PORT	D8_GPIO_Port
+#define DISPLAY_EN_PIN	D9_Pin
+#define DISPLAY_EN_PORT	D9_GPIO_Port
+#define DISPLAY_RW_PIN	A4_Pin		/* Tie RW low when DISPLAY_USE_BUSY_FLAG is 0 */
+#define DISPLAY_RW_PORT	A4_GPIO_Port
+
+/* PCF8574 I2C backpack on I2C1, remapped to D15 (SCL) and D14 (SDA) */
+#define DISPLAY_I2C_SCL_PIN		GPIO_PIN_8
+#define DISPLAY_I2C_SCL_PORT	GPIOB
+#define DISPLAY_I2C_SDA_PIN		GPIO_PIN_9
+#define DISPLAY_I2C_SDA_PORT	GPIOB
+#define DISPLAY_I2C_ADDRESS		0x27	/* 7-bit, A2..A0 open; 0x3F on a PCF8574A */
+
+/* 4x4 keypad on the morpho header: rows PC8..PC11, columns PC2..PC5 */
+#define KEYPAD_ROW_PORT			GPIOC
+#define KEYPAD_ROW_0_PIN		GPIO_PIN_8
+#define KEYPAD_ROW_1_PIN		GPIO_PIN_9
+#define KEYPAD_ROW_2_PIN		GPIO_PIN_10
+#define KEYPAD_ROW_3_PIN		GPIO_PIN_11
+#define KEYPAD_COLUMN_PORT		GPIOC
+#define KEYPAD_COLUMN_SHIFT		2		/* Column 0 on PC2, 3 on PC5 */
+
 #endif
 
 /* STM32 Nucleo Boards - 144 Pins */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023 Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : debounce.h
+ * @date   : Set 26, 2023
+ * @author : Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef DEBOUNCE_INC_DEBOUNCE_H_
+#define DEBOUNCE_INC_DEBOUNCE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/********************** macros ***********************************************/
+
+/********************** typedef **********************************************/
+/* Vertical Counter
+ *
+ * 	Up to 16 inputs, one bit lane each, debounced at the same time. A lane
+ * 	whose sample differs from its debounced state counts, one that agrees
+ * 	restarts; reaching its tick_max toggles the state and restarts it.
+ *
+ * 	count and tick_max are arrays of 'bits' bit planes: word b holds bit b
+ * 	of every lane, so each lane may have its own threshold and the cost
+ * 	does not depend on the number of lanes.
+ */
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+void debounce_tick_max_set(uint16_t *p_tick_max, uint32_t bits, uint16_t lanes, uint32_t tick_max);
+uint16_t debounce_update(uint16_t *p_state, uint16_t *p_count, const uint16_t *p_tick_max, uint32_t bits, uint16_t sample);
+bool debounce_counting(const uint16_t *p_count, uint32_t bits);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEBOUNCE_INC_DEBOUNCE_H_ */
+
+/********************** end of file ******************************************/
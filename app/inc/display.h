@@ -4,14 +4,30 @@
 #define _DISPLAY_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 //=====[Declaration of public defines]=========================================
 
+// 1: each command ends when the busy flag clears, never later than its
+// fixed delay. RW must be wired: a busy flag read with RW tied low is an
+// instruction write. 0: RW tied low, fixed delays only
+#define DISPLAY_USE_BUSY_FLAG   0
+
+#define DISPLAY_COLUMNS         20
+#define DISPLAY_ROWS            4
+
+// CGRAM user glyphs. Codes 8..15 show glyphs 0..7 and, unlike code 0, can
+// be part of a string. displayBarWrite() owns glyphs 0..3
+#define DISPLAY_GLYPH_QTY       8
+#define DISPLAY_GLYPH_ROWS      8
+#define DISPLAY_GLYPH_CHAR( glyph )   ( (char)( 0x08 + (glyph) ) )
+
 //=====[Declaration of public data types]======================================
 
 typedef enum {
      DISPLAY_CONNECTION_GPIO_4BITS,
      DISPLAY_CONNECTION_GPIO_8BITS,
+     DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER,
 } displayConnection_t;
 
 typedef struct {
@@ -22,10 +38,38 @@ typedef struct {
 
 void displayInit( displayConnection_t connection );
 
+void displayUpdate( void );
+
+bool displayReady( void );
+
 void displayCharPositionWrite( uint8_t charPositionX, uint8_t charPositionY );
 
 void displayStringWrite( const char * str );
 
+void displayRegionWrite( uint8_t charPositionX, uint8_t charPositionY,
+                         const char *buffer, uint8_t length );
+
+void displayScreenWrite( const char *screen );
+
+void displayGlyphLoad( uint8_t glyph, const uint8_t *bitmap );
+
+void displayBarWrite( uint8_t charPositionX, uint8_t charPositionY,
+                      uint8_t width, uint32_t value, uint32_t valueMax );
+
+void displayFlush( void );
+
+bool displayBusy( void );
+
+bool displayDirty( void );
+
+void displayTimerIrqHandler( void );
+
+void displayI2cEventIrqHandler( void );
+
+void displayI2cErrorIrqHandler( void );
+
+void displayI2cDmaIrqHandler( void );
+
 //=====[#include guards - end]=================================================
 
 #endif // _DISPLAY_H_
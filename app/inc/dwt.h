@@ -45,6 +45,19 @@ extern "C" {
 
 /********************** inclusions *******************************************/
 
+/********************** typedef **********************************************/
+typedef struct {
+	uint32_t start;		// CYCCNT at dwt_region_begin()
+	uint32_t last;		// Cycles of the last begin/end pair
+	uint32_t max;		// Worst cycles seen
+	uint32_t cnt;		// Completed begin/end pairs
+	uint64_t total;		// Sum of cycles
+} dwt_region_t;
+
+/********************** external data declaration ****************************/
+extern volatile uint32_t g_dwt_cyccnt_high;
+extern volatile uint32_t g_dwt_cyccnt_last;
+
 /********************** macros ***********************************************/
 
 /* init cycle counter */
@@ -99,6 +112,76 @@ static inline uint32_t cycle_counter_get_time_us(void)
 	return (DWT->CYCCNT / (SystemCoreClock / 1000000));
 }
 
+/* Free-running timestamps */
+/* CYCCNT is never reset after dwt_init(); it is extended to 64 bits by
+ * dwt_update(), called from the SysTick callback (CYCCNT wraps every
+ * 2^32 cycles, about 67 s at 64 MHz). Differences of 32-bit readings are
+ * wrap-safe for intervals shorter than that. */
+static inline uint64_t dwt_now(void) __attribute__((always_inline));
+static inline uint64_t dwt_now(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t high, low;
+
+	__disable_irq();
+	high = g_dwt_cyccnt_high;
+	low = DWT->CYCCNT;
+	/* Wrapped since the last dwt_update() */
+	if (low < g_dwt_cyccnt_last)
+	{
+		high++;
+	}
+	__set_PRIMASK(primask);
+
+	return (((uint64_t)high << 32) | low);
+}
+
+static inline uint64_t dwt_elapsed(uint64_t start) __attribute__((always_inline));
+static inline uint64_t dwt_elapsed(uint64_t start)
+{
+	return (dwt_now() - start);
+}
+
+static inline uint32_t dwt_elapsed32(uint32_t start) __attribute__((always_inline));
+static inline uint32_t dwt_elapsed32(uint32_t start)
+{
+	return (DWT->CYCCNT - start);
+}
+
+static inline uint64_t dwt_cycles_to_ns(uint64_t cycles) __attribute__((always_inline));
+static inline uint64_t dwt_cycles_to_ns(uint64_t cycles)
+{
+	return ((cycles * 1000) / (SystemCoreClock / 1000000));
+}
+
+static inline uint32_t dwt_cycles_to_us(uint32_t cycles) __attribute__((always_inline));
+static inline uint32_t dwt_cycles_to_us(uint32_t cycles)
+{
+	return (cycles / (SystemCoreClock / 1000000));
+}
+
+/* Measurement regions: begin/end pairs may nest, they never touch CYCCNT */
+static inline void dwt_region_begin(dwt_region_t *p_region) __attribute__((always_inline));
+static inline void dwt_region_begin(dwt_region_t *p_region)
+{
+	p_region->start = DWT->CYCCNT;
+}
+
+static inline uint32_t dwt_region_end(dwt_region_t *p_region) __attribute__((always_inline));
+static inline uint32_t dwt_region_end(dwt_region_t *p_region)
+{
+	uint32_t cycles = DWT->CYCCNT - p_region->start;
+
+	p_region->last = cycles;
+	p_region->total += cycles;
+	p_region->cnt++;
+	if (p_region->max < cycles)
+	{
+		p_region->max = cycles;
+	}
+	return cycles;
+}
+
 /*  uint32_t cycle_counter = 0;
  *  uint32_t cycle_counter_time_us = 0;
  *															// PC8 (GPIO)
@@ -124,11 +207,9 @@ static inline uint32_t cycle_counter_get_time_us(void)
  *  LOGGER_LOG("Cycles: %lu - Time %lu uS\r\n", cycle_counter, cycle_counter_time_us);
  */
 
-/********************** typedef **********************************************/
-
-/********************** external data declaration ****************************/
-
 /********************** external functions declaration ***********************/
+void dwt_init(void);
+void dwt_update(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
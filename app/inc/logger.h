@@ -53,9 +53,23 @@ extern "C" {
 
 #define LOGGER_CONFIG_ENABLE                    (1)
 #define LOGGER_CONFIG_MAXLEN                    (64)
-#define LOGGER_CONFIG_USE_SEMIHOSTING           (1)
-
-#if 1 == LOGGER_CONFIG_ENABLE
+#define LOGGER_CONFIG_USE_SEMIHOSTING           (0)
+#define LOGGER_CONFIG_USE_UART                  (1)
+#define LOGGER_CONFIG_RING_SIZE                 (1024) /* power of two */
+#define LOGGER_CONFIG_UART_IRQ_PRIORITY         (15)
+#define LOGGER_CONFIG_USE_TRACE                 (1)
+#define LOGGER_CONFIG_TRACE_MAXARGS             (8)
+
+#if (1 == LOGGER_CONFIG_ENABLE) && (1 == LOGGER_CONFIG_USE_UART)
+/* Format on the caller's stack, queue the bytes, let USART2 drain them */
+#define LOGGER_LOG(...)\
+    {\
+        char logger_msg_local_[LOGGER_CONFIG_MAXLEN];\
+        int logger_msg_local_len_;\
+        logger_msg_local_len_ = snprintf(logger_msg_local_, LOGGER_CONFIG_MAXLEN, __VA_ARGS__);\
+        logger_log_write_(logger_msg_local_, logger_msg_local_len_);\
+    }
+#elif 1 == LOGGER_CONFIG_ENABLE
 #define LOGGER_LOG(...)\
 	__asm("CPSID i");	/* disable interrupts*/\
     {\
@@ -72,16 +86,44 @@ extern "C" {
     LOGGER_LOG(__VA_ARGS__);\
     LOGGER_LOG("\n");
 
+/* Binary trace: the format string stays in the ELF (.trace_fmt), only
+ * its ID, a DWT cycle-count timestamp and the raw 32-bit arguments are
+ * queued. Arguments must be 32-bit integers (cast pointers; %s works for
+ * strings in flash). Decode on the host with app/tools/logger_trace_decode.py;
+ * app/tools/logger_trace_check round-trips a capture through it.
+ *
+ * Record: 0x1E | nargs | id (4) | timestamp (4) | args (4 * nargs), LE */
+#define LOGGER_TRACE_SYNC                       (0x1E)
+#define LOGGER_TRACE_HEADER_LEN                 (10)
+
+#if (1 == LOGGER_CONFIG_ENABLE) && (1 == LOGGER_CONFIG_USE_UART) && (1 == LOGGER_CONFIG_USE_TRACE)
+#define LOGGER_TRACE(fmt, ...)\
+    {\
+        static const char logger_trace_fmt_[] __attribute__((section(".trace_fmt"), used)) = fmt;\
+        const uint32_t logger_trace_args_[] = {0, ##__VA_ARGS__};\
+        logger_trace_write_((uint32_t)logger_trace_fmt_,\
+                            (sizeof(logger_trace_args_) / sizeof(uint32_t)) - 1,\
+                            &logger_trace_args_[1]);\
+    }
+#else
+#define LOGGER_TRACE(fmt, ...)\
+    LOGGER_INFO(fmt, ##__VA_ARGS__)
+#endif
+
 #define GET_NAME(var)  #var
 
 /********************** typedef **********************************************/
 
 extern char* const logger_msg;
 extern int logger_msg_len; // only for debug information
+extern uint32_t logger_dropped; // messages lost on a full ring
 
 /********************** external functions declaration ***********************/
 
 void logger_log_print_(char* const msg);
+void logger_log_write_(const char* msg, int len);
+void logger_uart_irq_handler(void);
+void logger_trace_write_(uint32_t id, uint32_t nargs, const uint32_t* args);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
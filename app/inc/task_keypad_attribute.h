@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023 Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : task_keypad_attribute.h
+ * @date   : Set 26, 2023
+ * @author : Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef TASK_INC_TASK_KEYPAD_ATTRIBUTE_H_
+#define TASK_INC_TASK_KEYPAD_ATTRIBUTE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+/********************** macros ***********************************************/
+#define KEYPAD_ROWS			4ul
+#define KEYPAD_COLUMNS		4ul
+#define KEYPAD_KEY_QTY		(KEYPAD_ROWS * KEYPAD_COLUMNS)
+
+/* Bit planes of the debounce counters, counted in full scans */
+#define KEYPAD_COUNT_BITS	3ul
+
+/********************** typedef **********************************************/
+/* Keypad Scanner - Matrix Scan
+ *
+ * 	One row is driven low per tick and its columns are read one tick later,
+ * 	in a single port read, so every row settles for a whole tick. Each full
+ * 	scan leaves one bit per key in 'scan' (bit = row * KEYPAD_COLUMNS +
+ * 	column, 1 = pressed), which is debounced like the buttons of
+ * 	task_sensor by the vertical counter of debounce.h: it toggles the
+ * 	debounced 'state' of a key after tick_max scans that disagree with it.
+ */
+
+typedef struct
+{
+	GPIO_TypeDef *		row_port;
+	uint16_t			row_pin[KEYPAD_ROWS];
+	GPIO_TypeDef *		column_port;
+	uint32_t			column_shift;		/* Columns are contiguous pins from this one */
+	uint32_t			tick_max;			/* Scans a key must hold to toggle */
+	task_menu_ev_t		signal_down[KEYPAD_KEY_QTY];
+} task_keypad_cfg_t;
+
+typedef struct
+{
+	uint32_t			row;				/* Row being driven */
+	uint16_t			scan;				/* Keys seen down in the scan under way */
+	uint16_t			state;				/* Debounced, 1 = pressed */
+	uint16_t			count[KEYPAD_COUNT_BITS];	/* Scans against state, bit planes */
+	uint16_t			tick_max[KEYPAD_COUNT_BITS];	/* cfg tick_max of every key, bit planes */
+} task_keypad_dta_t;
+
+/********************** external data declaration ****************************/
+extern task_keypad_dta_t task_keypad_dta;
+
+/********************** external functions declaration ***********************/
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_INC_TASK_KEYPAD_ATTRIBUTE_H_ */
+
+/********************** end of file ******************************************/
@@ -53,14 +53,44 @@ extern "C" {
  * 	| Current               | Event                 |                       | Next                  |                       |
  * 	| State                 | (Parameters)          | [Guard]               | State                 | Actions               |
  * 	|=======================+=======================+=======================+=======================+=======================|
- * 	| INICIAL               |                       |                       | ST_MEN_XX_IDLE        |                       |
+ * 	| INICIAL               |                       |                       | ST_MEN_XX_MAIN        |                       |
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_MEN_XX_IDLE        | EV_MEN_MEN_ACTIVE     |                       | ST_MEN_XX_ACTIVE      |                       |
- * 	|                       |                       |                       |                       |                       |
+ * 	| ST_MEN_XX_MAIN        | EV_MEN_ENT_ACTIVE     |                       | ST_MEN_XX_MOTOR       | motor = 0             |
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_MEN_XX_ACTIVE      | EV_MEN_MEN_IDLE       |                       | ST_MEN_XX_IDLE        |                       |
- * 	|                       |                       |                       |                       |                       |
+ * 	| ST_MEN_XX_MOTOR       | EV_MEN_ENT_ACTIVE     |                       | ST_MEN_XX_PARAM       | parameter = 0         |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_NEX_ACTIVE     |                       | ST_MEN_XX_MOTOR       | motor++ (cyclic)      |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_ESC_ACTIVE     |                       | ST_MEN_XX_MAIN        |                       |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_MEN_XX_PARAM       | EV_MEN_ENT_ACTIVE     |                       | ST_MEN_XX_OPTION      | option = 0            |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_NEX_ACTIVE     |                       | ST_MEN_XX_PARAM       | parameter++ (cyclic)  |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_ESC_ACTIVE     |                       | ST_MEN_XX_MOTOR       |                       |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_MEN_XX_OPTION      | EV_MEN_ENT_ACTIVE     |                       | ST_MEN_XX_PARAM       | set(motor, option)    |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_NEX_ACTIVE     |                       | ST_MEN_XX_OPTION      | option++ (cyclic)     |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_ESC_ACTIVE     |                       | ST_MEN_XX_PARAM       |                       |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| any                   | EV_MEN_NEX_REPEAT     |                       | as EV_MEN_NEX_ACTIVE  | as EV_MEN_NEX_ACTIVE  |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_ESC_LONG       |                       | ST_MEN_XX_MAIN        |                       |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_MEN_ENT_ESC_CHORD  |                       | ST_MEN_XX_MAIN        | every motor off       |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_MEN_XX_MOTOR       | EV_MEN_KEY_n          | [0 < n <= motors]     | ST_MEN_XX_MOTOR       | motor = n - 1         |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_MEN_XX_PARAM       | EV_MEN_KEY_n          | [0 < n <= parameters] | ST_MEN_XX_PARAM       | parameter = n - 1     |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_MEN_XX_OPTION      | EV_MEN_KEY_n          | [n < options]         | ST_MEN_XX_OPTION      | option = n            |
  * 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
+ *
+ *  The table above is stored as task_menu_node_list (one node per state);
+ *  motor, parameter and option index the motor and parameter lists, so
+ *  adding motors or parameters adds rows to those lists, not states.
  */
 
 /* Events to excite Task Menu */
@@ -69,46 +99,33 @@ typedef enum task_menu_ev {EV_MEN_ENT_IDLE,
 						   EV_MEN_NEX_IDLE,
 						   EV_MEN_NEX_ACTIVE,
 						   EV_MEN_ESC_IDLE,
-						   EV_MEN_ESC_ACTIVE} task_menu_ev_t;
+						   EV_MEN_ESC_ACTIVE,
+						   EV_MEN_NEX_REPEAT,
+						   EV_MEN_ESC_LONG,
+						   EV_MEN_ENT_ESC_CHORD,
+						   EV_MEN_KEY_0,
+						   EV_MEN_KEY_1,
+						   EV_MEN_KEY_2,
+						   EV_MEN_KEY_3,
+						   EV_MEN_KEY_4,
+						   EV_MEN_KEY_5,
+						   EV_MEN_KEY_6,
+						   EV_MEN_KEY_7,
+						   EV_MEN_KEY_8,
+						   EV_MEN_KEY_9} task_menu_ev_t;
 
 /* State of Task Menu */
 typedef enum task_menu_st {ST_MEN_XX_MAIN,
-						   ST_MEN_XX_MOTOR_1,
-						   ST_MEN_XX_MOTOR_2,
-						   ST_MEN_XX_POWER_1,
-						   ST_MEN_XX_POWER_2,
-						   ST_MEN_XX_SPEED_1,
-						   ST_MEN_XX_SPEED_2,
-						   ST_MEN_XX_SPIN_1,
-						   ST_MEN_XX_SPIN_2,
-						   ST_MEN_XX_POWER_1_ON,
-						   ST_MEN_XX_POWER_1_OFF,
-						   ST_MEN_XX_POWER_2_ON,
-						   ST_MEN_XX_POWER_2_OFF,
-						   ST_MEN_XX_SPIN_1_L,
-						   ST_MEN_XX_SPIN_1_R,
-						   ST_MEN_XX_SPIN_2_L,
-						   ST_MEN_XX_SPIN_2_R,
-						   ST_MEN_XX_SPEED_1_0,
-						   ST_MEN_XX_SPEED_1_1,
-						   ST_MEN_XX_SPEED_1_2,
-						   ST_MEN_XX_SPEED_1_3,
-						   ST_MEN_XX_SPEED_1_4,
-						   ST_MEN_XX_SPEED_1_5,
-						   ST_MEN_XX_SPEED_1_6,
-						   ST_MEN_XX_SPEED_1_7,
-						   ST_MEN_XX_SPEED_1_8,
-						   ST_MEN_XX_SPEED_1_9,
-						   ST_MEN_XX_SPEED_2_0,
-						   ST_MEN_XX_SPEED_2_1,
-						   ST_MEN_XX_SPEED_2_2,
-						   ST_MEN_XX_SPEED_2_3,
-						   ST_MEN_XX_SPEED_2_4,
-						   ST_MEN_XX_SPEED_2_5,
-						   ST_MEN_XX_SPEED_2_6,
-						   ST_MEN_XX_SPEED_2_7,
-						   ST_MEN_XX_SPEED_2_8,
-						   ST_MEN_XX_SPEED_2_9} task_menu_st_t;
+						   ST_MEN_XX_MOTOR,
+						   ST_MEN_XX_PARAM,
+						   ST_MEN_XX_OPTION,
+						   ST_MEN_XX_QTY} task_menu_st_t;
+
+/* Parameters of a motor */
+typedef enum task_menu_par {ID_PAR_POWER,
+							ID_PAR_SPIN,
+							ID_PAR_SPEED,
+							ID_PAR_QTY} task_menu_par_t;
 
 typedef struct
 {
@@ -117,6 +134,9 @@ typedef struct
 	task_menu_ev_t	event;
 	bool			flag;
 	bool			flag_lcd;
+	uint32_t		motor;		// Index in motor_dta_list
+	task_menu_par_t	parameter;	// Index in task_menu_par_cfg_list
+	uint32_t		option;		// Index in the parameter option list
 } task_menu_dta_t;
 
 typedef struct
@@ -126,7 +146,24 @@ typedef struct
 	uint32_t		speed; //0 to 9
 } motor_dta_t;
 
-
+/* Menu tree node: one per state, looked up by state */
+typedef struct
+{
+	task_menu_st_t	parent;								// Reached on ESC
+	void			(*enter)(task_menu_dta_t *);		// Action on ENT
+	void			(*next)(task_menu_dta_t *);			// Action on NEX
+	void			(*digit)(task_menu_dta_t *, uint32_t);	// Action on a keypad digit
+	void			(*render)(const task_menu_dta_t *);	// LCD screen
+} task_menu_node_t;
+
+/* Motor parameter: editable options, listed in NEX order */
+typedef struct
+{
+	const char *		name;
+	const char * const *option_name;
+	uint32_t			option_qty;
+	void				(*set)(motor_dta_t *, uint32_t option);
+} task_menu_par_cfg_t;
 
 /********************** external data declaration ****************************/
 extern task_menu_dta_t task_menu_dta;
@@ -56,6 +56,8 @@ extern void init_queue_event_task_menu(void);
 extern void put_event_task_menu(task_menu_ev_t event);
 extern task_menu_ev_t get_event_task_menu(void);
 extern bool any_event_task_menu(void);
+extern uint32_t get_overflow_event_task_menu(void);
+extern uint32_t get_high_watermark_event_task_menu(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
@@ -56,6 +56,8 @@ extern volatile uint32_t g_task_sensor_tick_cnt;
 /********************** external functions declaration ***********************/
 extern void task_sensor_init(void *parameters);
 extern void task_sensor_update(void *parameters);
+extern bool task_sensor_idle(void);
+extern void task_sensor_exti_irq_handler(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
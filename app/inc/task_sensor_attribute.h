@@ -46,53 +46,56 @@ extern "C" {
 /********************** inclusions *******************************************/
 
 /********************** macros ***********************************************/
+/* Bit planes of the debounce counters, tick_max must fit in them */
+#define SENSOR_COUNT_BITS	6ul
+
+/* 1: a timer triggers DMA reads of the button ports into circular buffers
+ * and every release debounces the samples taken since the previous one.
+ * 0: every release reads the ports itself */
+#define SENSOR_SAMPLE_DMA	0
+#define SENSOR_DMA_SAMPLES	64ul	/* Per port, a power of two */
 
 /********************** typedef **********************************************/
-/* Sensor Statechart - State Transition Table */
-/* 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
- * 	| Current               | Event                 |                       | Next                  |                       |
- * 	| State                 | (Parameters)          | [Guard]               | State                 | Actions               |
+/* Sensor Debouncer - Vertical Counter
+ *
+ * 	Each button is one bit lane of its GPIO port. Every tick the port IDR is
+ * 	read once and, for all lanes at the same time:
+ *
+ * 	| Sample vs. debounced  | Counter               | [Guard]               | Debounced             | Actions               |
  * 	|=======================+=======================+=======================+=======================+=======================|
- * 	| INICIAL               |                       |                       | ST_BTN_XX_UP          |                       |
+ * 	| equal                 | count = 0             |                       |                       |                       |
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_BTN_XX_UP          | EV_BTN_XX_UP          |                       | ST_BTN_XX_UP          |                       |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        |                       | ST_BTN_XX_FALLING     | tick = TICK_MAX       |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_BTN_XX_FALLING     | EV_BTN_XX_UP          | [tick == 0]           | ST_BTN_XX_UP          |                       |
+ * 	| different             | count++               | [count <  tick_max]   |                       |                       |
  * 	|                       |                       +-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick >  0]           | ST_BTN_XX_FALLING     | tick--                |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        | [tick == 0]           | ST_BTN_XX_DOWN        | put_event_task_system |
- * 	|                       |                       |                       |                       |  (event)              |
- * 	|                       |						+-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick >  0]           | ST_BTN_XX_FALLING     | tick--                |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- *	| ST_BTN_XX_DOWN        | EV_BTN_XX_UP          |                       | ST_BTN_XX_RISING      | tick = TICK_MAX       |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        |                       | ST_BTN_XX_DOWN        |                       |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_BTN_XX_RISING      | EV_BTN_XX_UP          | [tick == 0]           | ST_BTN_XX_UP          | put_event_task_system |
- * 	|                       |                       |                       |                       |  (event)              |
- * 	|                       |						+-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick >  0]           | ST_BTN_XX_RISING      | tick--                |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        | [tick == 0]           | ST_BTN_XX_DOWN        |                       |
- * 	|                       |						+-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick >  0]           | ST_BTN_XX_RISING      | tick--                |
+ * 	|                       |                       | [count == tick_max]   | toggled, count = 0    | put_event_task_menu   |
+ * 	|                       |                       |                       |                       |  (signal_up/down)     |
  * 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
+ *
+ * 	count and tick_max are stored as bit planes: bit b of every lane of a
+ * 	port lives in one word, so the cost does not depend on the button count
+ * 	(debounce.h, shared with task_keypad).
+ *
+ * 	Pins that own their EXTI line are only sampled from an edge until their
+ * 	count is back to 0, pins whose line is taken are sampled on every release.
+ *
+ * 	A button held for tick_long emits signal_long, then, if tick_repeat_max
+ * 	is not 0, signal_repeat every period; the period shrinks by a quarter
+ * 	per repeat down to tick_repeat_min. A chord emits its signal once when
+ * 	all of its buttons are down, again only after one of them is released.
+ * 	The signal_down of a chord button is withheld for a short window: if the
+ * 	chord completes within it, only the chord signal is emitted; otherwise
+ * 	signal_down follows when the window ends or at the release.
+ *
+ * 	With SENSOR_SAMPLE_DMA the sample of a release is the batch the DMA
+ * 	took since the previous one: a lane counts as pressed or released only
+ * 	if every sample of the batch agrees, a lane that bounced within the
+ * 	batch agrees with the debounced state. EXTI wakeup is not used then.
  */
 
 /* Events to excite Task Sensor */
 typedef enum task_sensor_ev {EV_BTN_XX_UP,
 							 EV_BTN_XX_DOWN} task_sensor_ev_t;
 
-/* States of Task Sensor */
-typedef enum task_sensor_st {ST_BTN_XX_UP,
-							 ST_BTN_XX_FALLING,
-							 ST_BTN_XX_DOWN,
-						     ST_BTN_XX_RISING} task_sensor_st_t;
-
 /* Identifier of Task Sensor */
 typedef enum task_sensor_id {ID_BTN_ENT,
 							 ID_BTN_NEX,
@@ -107,15 +110,51 @@ typedef struct
 	uint32_t			tick_max;
 	task_sensor_ev_t	signal_up;
 	task_sensor_ev_t	signal_down;
+	uint32_t			tick_long;			/* 0 = no long press */
+	task_sensor_ev_t	signal_long;
+	uint32_t			tick_repeat_max;	/* First repeat period, 0 = no repeat */
+	uint32_t			tick_repeat_min;	/* Fastest repeat period */
+	task_sensor_ev_t	signal_repeat;
 } task_sensor_cfg_t;
 
 typedef struct
 {
-	uint32_t			tick;
-	task_sensor_st_t	state;
-	task_sensor_ev_t	event;
+	uint32_t			buttons;			/* 1 << task_sensor_id_t of each button */
+	task_sensor_ev_t	signal;
+} task_sensor_chord_cfg_t;
+
+typedef struct
+{
+	GPIO_TypeDef *		gpio_port;
+	uint16_t			mask;							/* Button pins on this port */
+	uint16_t			exti;							/* Pins that wake the task by EXTI */
+	uint16_t			inverted;						/* Pins pressed at GPIO_PIN_RESET */
+	uint16_t			state;							/* Debounced, 1 = pressed */
+	uint16_t			count[SENSOR_COUNT_BITS];		/* Samples against state, bit planes */
+	uint16_t			tick_max[SENSOR_COUNT_BITS];	/* Per-pin threshold, bit planes */
+#if (1 == SENSOR_SAMPLE_DMA)
+	DMA_Channel_TypeDef *	dma;						/* NULL: read by the task */
+	uint32_t			tail;							/* Next sample to debounce */
+	uint16_t			sample[SENSOR_DMA_SAMPLES];		/* IDR, written by the DMA */
+#endif
 } task_sensor_dta_t;
 
+/* Timer DMA request able to copy a port IDR */
+typedef struct
+{
+	GPIO_TypeDef *			gpio_port;
+	DMA_Channel_TypeDef *	dma;
+	uint32_t				request;			/* TIM DIER bit of the request */
+} task_sensor_dma_cfg_t;
+
+/* Long press / repeat timer of a held button */
+typedef struct
+{
+	uint16_t			tick;				/* Ticks to the next long or repeat signal */
+	uint16_t			period;				/* Repeat period, 0 = long not emitted yet */
+	uint16_t			chord;				/* Ticks left to join a chord, down withheld */
+} task_sensor_hold_t;
+
 /********************** external data declaration ****************************/
 extern task_sensor_dta_t task_sensor_dta_list[];
 
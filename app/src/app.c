@@ -45,37 +45,79 @@
 
 /* Application & Tasks includes */
 #include "board.h"
+#include "app.h"
 #include "task_sensor.h"
+#include "task_keypad.h"
 #include "task_menu.h"
+#include "task_display.h"
 
 /********************** macros and definitions *******************************/
 #define G_APP_CNT_INI		0ul
 #define G_APP_TICK_CNT_INI	0ul
 
 #define TASK_X_WCET_INI		0ul
+#define TASK_X_BCET_INI		0xFFFFFFFFul
 #define TASK_X_DELAY_MIN	0ul
 
+#define APP_FRAME_US			1000ul	/* Cyclic executive period */
+#define APP_STATS_DUMP_PERIOD	10000ul	/* Ticks between dumps, 0 = never */
+#define APP_STATS_DUMP_STEP		30ul	/* Ticks between dump blocks, USART2 drains ~340 bytes */
+#define APP_STATS_DUMP_DONE		0xFFFFFFFFul
+
+/* Idle strategy, what app_update() does when no tick is pending */
+#define APP_IDLE_NONE			0		/* Return at once, main() spins */
+#define APP_IDLE_WFI			1		/* Sleep until the next interrupt */
+#define APP_IDLE_TICKLESS		2		/* As WFI, stretching SysTick while tasks are idle */
+
+#define APP_IDLE_MODE			APP_IDLE_WFI
+#define APP_IDLE_SLEEP_ON_EXIT	(0)		/* Stay asleep across non-SysTick interrupts */
+#define APP_TICKLESS_MAX_TICKS	20ul	/* Longest SysTick period (button poll latency) */
+
+#define APP_TICK_BACKLOG_MAX	8ul		/* Pending frames kept, older ticks are dropped */
+
+#define APP_DISPLAY_FRAME_PERIOD	33ul	/* LCD commits at most every 33 ticks (30 Hz) */
+
+/* What a release does when the previous one has not run yet */
+typedef enum app_overrun {
+	APP_OVERRUN_SKIP,				/* Coalesce: the task runs once */
+	APP_OVERRUN_CATCH_UP			/* Queue it, up to backlog_max releases */
+} app_overrun_t;
+
 typedef struct {
 	void (*task_init)(void *);		// Pointer to task (must be a
 									// 'void (void *)' function)
 	void (*task_update)(void *);	// Pointer to task (must be a
 									// 'void (void *)' function)
 	void *parameters;				// Pointer to parameters
+	volatile uint32_t *p_tick_cnt;	// Task tick counter, one count per release
+	uint32_t period;				// Release period (ticks, at least 1)
+	uint32_t offset;				// First release (ticks), staggers the tasks
+	uint32_t deadline;				// Relative deadline (microseconds)
+	app_overrun_t overrun;			// Overrun policy
+	uint32_t backlog_max;			// Pending releases kept by APP_OVERRUN_CATCH_UP
 } task_cfg_t;
 
-typedef struct {
-    uint32_t WCET;			// Worst-case execution time (microseconds)
-} task_dta_t;
-
 /********************** internal data declaration ****************************/
 const task_cfg_t task_cfg_list[]	= {
-		{task_sensor_init,	task_sensor_update, 	NULL},
-		{task_menu_init,	task_menu_update, 		NULL}
+		{task_sensor_init,	task_sensor_update, 	NULL,
+		 &g_task_sensor_tick_cnt,	 1ul,	 0ul,	 1000ul,	APP_OVERRUN_CATCH_UP,	4ul},
+		{task_keypad_init,	task_keypad_update,		NULL,
+		 &g_task_keypad_tick_cnt,	 1ul,	 0ul,	 1000ul,	APP_OVERRUN_SKIP,		1ul},
+		{task_menu_init,	task_menu_update, 		NULL,
+		 &g_task_menu_tick_cnt,		20ul,	10ul,	20000ul,	APP_OVERRUN_SKIP,		1ul},
+		{task_display_init,	task_display_update,	NULL,
+		 &g_task_display_tick_cnt,	APP_DISPLAY_FRAME_PERIOD,	15ul,	33000ul,	APP_OVERRUN_SKIP,	1ul}
 };
 
 #define TASK_QTY	(sizeof(task_cfg_list)/sizeof(task_cfg_t))
 
 /********************** internal functions declaration ***********************/
+uint32_t app_release_latency_us(void);
+void app_idle(void);
+uint32_t app_tickless_sleep(uint32_t ticks);
+void app_task_stats_update(task_dta_t *p_task_dta, uint32_t time_us, uint32_t release_us);
+bool app_task_release(uint32_t index, uint32_t ticks);
+void app_stats_dump_update(void);
 
 /********************** internal data definition *****************************/
 const char *p_sys	= " Bare Metal - Event-Triggered Systems (ETS)";
@@ -84,11 +126,25 @@ const char *p_app	= " App - Interactive Menu";
 /********************** external data declaration ****************************/
 uint32_t g_app_cnt;
 uint32_t g_app_runtime_us;
+uint32_t g_app_overrun_cnt;
+uint32_t g_app_skip_cnt;		/* Ticks dropped beyond APP_TICK_BACKLOG_MAX */
+
+uint64_t g_app_busy_cycles;		/* Cycles spent running frames since app_stats_reset() */
+uint32_t g_app_idle_tick_ini;	/* HAL tick at app_stats_reset() */
+uint32_t g_app_sleep_cnt;		/* WFI executed */
+uint32_t g_app_tickless_cnt;	/* SysTick interrupts suppressed by tickless idle */
 
 volatile uint32_t g_app_tick_cnt;
 
 task_dta_t task_dta_list[TASK_QTY];
 
+uint32_t task_countdown_list[TASK_QTY];	/* Ticks to the next release */
+
+uint32_t app_dump_block = APP_STATS_DUMP_DONE;	/* Next dump block, 0 = app totals */
+uint32_t app_dump_countdown;					/* Ticks to the next dump block */
+uint32_t app_tick_reload;						/* Nominal SysTick LOAD, tickless idle rewrites LOAD */
+volatile bool app_tick_reload_pending;			/* Short realigning tick running */
+
 /********************** external functions definition ************************/
 void app_init(void)
 {
@@ -106,26 +162,33 @@ void app_init(void)
 	LOGGER_INFO(" %s = %lu", GET_NAME(g_app_cnt), g_app_cnt);
 
 	/* Init Cycle Counter */
-	cycle_counter_init();
+	dwt_init();
+
+	/* SysTick is set up by HAL_Init(), its LOAD is the nominal tick from now on */
+	app_tick_reload = SysTick->LOAD;
 
     /* Go through the task arrays */
 	for (index = 0; TASK_QTY > index; index++)
 	{
 		/* Run task_x_init */
 		(*task_cfg_list[index].task_init)(task_cfg_list[index].parameters);
-
-		/* Init variables */
-		task_dta_list[index].WCET = TASK_X_WCET_INI;
 	}
 
+	/* Init variables */
+	app_stats_reset();
+
 	/* Protect shared resource */
 	__asm("CPSID i");	/* disable interrupts */
 	/* Init Tick Counter */
 	g_app_tick_cnt = G_APP_TICK_CNT_INI;
 
-	g_task_sensor_tick_cnt = G_APP_TICK_CNT_INI;
-	g_task_menu_tick_cnt = G_APP_TICK_CNT_INI;
     __asm("CPSIE i");	/* enable interrupts */
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		*task_cfg_list[index].p_tick_cnt = G_APP_TICK_CNT_INI;
+		task_countdown_list[index] = task_cfg_list[index].offset;
+	}
 }
 
 void app_update(void)
@@ -133,14 +196,22 @@ void app_update(void)
 	uint32_t index;
 	bool b_time_update_required = false;
 	uint32_t cycle_counter_time_us;
+	uint32_t frame_start;
+	uint32_t release_us = 0;
+	uint32_t ticks = 0;
+	uint32_t release_ticks;
 
 	/* Protect shared resource */
 	__asm("CPSID i");	/* disable interrupts */
     if (G_APP_TICK_CNT_INI < g_app_tick_cnt)
     {
-		/* Update Tick Counter */
+		/* Update Tick Counter: a late frame takes every pending tick, the
+		 * overrun policy of each task decides what runs */
     	g_app_tick_cnt--;
     	b_time_update_required = true;
+    	release_us = app_release_latency_us();
+    	ticks = 1 + g_app_tick_cnt;
+    	g_app_tick_cnt = G_APP_TICK_CNT_INI;
     }
     __asm("CPSIE i");	/* enable interrupts */
 
@@ -150,26 +221,52 @@ void app_update(void)
     	/* Update App Counter */
     	g_app_cnt++;
     	g_app_runtime_us = 0;
+    	frame_start = cycle_counter_get();
 
 		/* Go through the task arrays */
 		for (index = 0; TASK_QTY > index; index++)
 		{
-			cycle_counter_reset();
+			/* Each task_x_update consumes one release, CATCH_UP runs the
+			 * queued ones back to back */
+			release_ticks = ticks;
+			while (true == app_task_release(index, release_ticks))
+			{
+				release_ticks = 0;	/* Released once per frame */
 
-    		/* Run task_x_update */
-			(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
+				dwt_region_begin(&task_dta_list[index].region);
 
-			cycle_counter_time_us = cycle_counter_get_time_us();
+				/* Run task_x_update */
+				(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
 
-			/* Update variables */
-			g_app_runtime_us += cycle_counter_time_us;
+				cycle_counter_time_us = dwt_cycles_to_us(dwt_region_end(&task_dta_list[index].region));
 
-			if (task_dta_list[index].WCET < cycle_counter_time_us)
-			{
-				task_dta_list[index].WCET = cycle_counter_time_us;
+				/* Update variables: the task was released g_app_runtime_us
+				 * after the frame, which started release_us after its tick */
+				app_task_stats_update(&task_dta_list[index], cycle_counter_time_us,
+									  release_us + g_app_runtime_us);
+
+				g_app_runtime_us = dwt_cycles_to_us(dwt_elapsed32(frame_start));
+
+				if (task_cfg_list[index].deadline < release_us + g_app_runtime_us)
+				{
+					task_dta_list[index].deadline_miss++;
+				}
 			}
 		}
 
+		g_app_busy_cycles += dwt_elapsed32(frame_start);
+
+		if (APP_FRAME_US < g_app_runtime_us)
+		{
+			g_app_overrun_cnt++;
+		}
+
+		if ((0 != APP_STATS_DUMP_PERIOD) && (0 == (g_app_cnt % APP_STATS_DUMP_PERIOD)))
+		{
+			app_stats_dump();
+		}
+		app_stats_dump_update();
+
 		/* Protect shared resource */
 		__asm("CPSID i");	/* disable interrupts */
 		if (G_APP_TICK_CNT_INI < g_app_tick_cnt)
@@ -177,6 +274,9 @@ void app_update(void)
 			/* Update Tick Counter */
 			g_app_tick_cnt--;
 			b_time_update_required = true;
+			release_us = app_release_latency_us();
+			ticks = 1 + g_app_tick_cnt;
+			g_app_tick_cnt = G_APP_TICK_CNT_INI;
 		}
 		else
 		{
@@ -184,15 +284,370 @@ void app_update(void)
 		}
 		__asm("CPSIE i");	/* enable interrupts */
 	}
+
+	app_idle();
+}
+
+uint32_t app_task_qty(void)
+{
+	return TASK_QTY;
+}
+
+const task_dta_t *app_task_dta_get(uint32_t index)
+{
+	if (TASK_QTY <= index)
+	{
+		return NULL;
+	}
+	return &task_dta_list[index];
+}
+
+void app_stats_reset(void)
+{
+	uint32_t index;
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		memset(&task_dta_list[index], 0, sizeof(task_dta_t));
+		task_dta_list[index].WCET = TASK_X_WCET_INI;
+		task_dta_list[index].BCET = TASK_X_BCET_INI;
+	}
+	g_app_overrun_cnt = 0;
+	g_app_skip_cnt = 0;
+
+	g_app_busy_cycles = 0;
+	g_app_idle_tick_ini = HAL_GetTick();
+	g_app_sleep_cnt = 0;
+	g_app_tickless_cnt = 0;
+}
+
+/* Per mille of the time since app_stats_reset() not spent running frames */
+uint32_t app_idle_permille(void)
+{
+	uint64_t total_cycles;
+
+	total_cycles = (uint64_t)(HAL_GetTick() - g_app_idle_tick_ini) * (app_tick_reload + 1);
+	if ((0 == total_cycles) || (g_app_busy_cycles >= total_cycles))
+	{
+		return 0;
+	}
+	return (uint32_t)(1000 - (g_app_busy_cycles * 1000) / total_cycles);
+}
+
+/* Starts a dump: app_update() logs one block per APP_STATS_DUMP_STEP ticks,
+ * so the logger ring never has to hold more than one block */
+void app_stats_dump(void)
+{
+	app_dump_block = 0;
+	app_dump_countdown = 0;
+}
+
+void app_stats_dump_update(void)
+{
+	uint32_t bin;
+	task_dta_t *p_task_dta;
+
+	if (APP_STATS_DUMP_DONE == app_dump_block)
+	{
+		return;
+	}
+	if (0 != app_dump_countdown)
+	{
+		app_dump_countdown--;
+		return;
+	}
+	app_dump_countdown = APP_STATS_DUMP_STEP;
+
+	if (0 == app_dump_block)
+	{
+		LOGGER_TRACE(" app cnt %lu overrun %lu skip %lu", g_app_cnt, g_app_overrun_cnt, g_app_skip_cnt);
+		LOGGER_TRACE(" idle [%%o] %lu sleeps %lu tickless %lu", app_idle_permille(),
+					 g_app_sleep_cnt, g_app_tickless_cnt);
+		app_dump_block++;
+		return;
+	}
+
+	/* Tasks that never ran have no block */
+	while ((TASK_QTY >= app_dump_block) && (0 == task_dta_list[app_dump_block - 1].cnt))
+	{
+		app_dump_block++;
+	}
+	if (TASK_QTY < app_dump_block)
+	{
+		app_dump_block = APP_STATS_DUMP_DONE;
+		return;
+	}
+
+	p_task_dta = &task_dta_list[app_dump_block - 1];
+
+	LOGGER_TRACE("  task %lu exec [uS] %lu/%lu/%lu [ns] %lu/%lu", app_dump_block - 1, p_task_dta->BCET,
+				 (uint32_t)(p_task_dta->sum / p_task_dta->cnt), p_task_dta->WCET,
+				 (uint32_t)dwt_cycles_to_ns(p_task_dta->region.last),
+				 (uint32_t)dwt_cycles_to_ns(p_task_dta->region.max));
+	LOGGER_TRACE("  task %lu miss %lu skip %lu jitter [uS] %lu/%lu", app_dump_block - 1,
+				 p_task_dta->deadline_miss, p_task_dta->skip_cnt,
+				 (uint32_t)(p_task_dta->jitter_sum / p_task_dta->cnt), p_task_dta->jitter_max);
+	for (bin = 0; TASK_X_HIST_QTY > bin; bin += 4)
+	{
+		LOGGER_TRACE("  task %lu hist[%lu] %lu %lu %lu %lu", app_dump_block - 1, bin,
+					 p_task_dta->hist[bin], p_task_dta->hist[bin + 1],
+					 p_task_dta->hist[bin + 2], p_task_dta->hist[bin + 3]);
+	}
+
+	app_dump_block++;
+}
+
+/* Posts the releases of task 'index' over the frame's 'ticks' and applies
+ * its overrun policy; true while the task has a release to run */
+bool app_task_release(uint32_t index, uint32_t ticks)
+{
+	const task_cfg_t *p_task_cfg = &task_cfg_list[index];
+	uint32_t releases = 0;
+	uint32_t elapsed;
+	uint32_t tick_cnt;
+	uint32_t tick_max;
+
+	if (task_countdown_list[index] < ticks)
+	{
+		elapsed = ticks - task_countdown_list[index] - 1;
+		releases = 1 + elapsed / p_task_cfg->period;
+		task_countdown_list[index] = p_task_cfg->period - 1 - elapsed % p_task_cfg->period;
+	}
+	else
+	{
+		task_countdown_list[index] -= ticks;
+	}
+
+	if (0 != releases)
+	{
+		tick_max = (APP_OVERRUN_CATCH_UP == p_task_cfg->overrun) ? p_task_cfg->backlog_max : 1;
+
+		/* Protect shared resource */
+		__asm("CPSID i");	/* disable interrupts */
+		tick_cnt = *p_task_cfg->p_tick_cnt + releases;
+		if (tick_max < tick_cnt)
+		{
+			task_dta_list[index].skip_cnt += tick_cnt - tick_max;
+			tick_cnt = tick_max;
+		}
+		*p_task_cfg->p_tick_cnt = tick_cnt;
+		__asm("CPSIE i");	/* enable interrupts */
+	}
+
+	return (G_APP_TICK_CNT_INI < *p_task_cfg->p_tick_cnt);
+}
+
+/* Time elapsed since the SysTick boundary that released the current frame */
+uint32_t app_release_latency_us(void)
+{
+	uint32_t cycles_per_us = SystemCoreClock / 1000000ul;
+	uint32_t tick_us = (app_tick_reload + 1) / cycles_per_us;
+	uint32_t pending = g_app_tick_cnt;
+
+	/* A tick that wrapped while interrupts are masked is not counted yet */
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		pending++;
+	}
+
+	/* VAL counts down to the next boundary of the grid, even in a short tick */
+	return (pending * tick_us) + ((app_tick_reload - SysTick->VAL) / cycles_per_us);
+}
+
+void app_task_stats_update(task_dta_t *p_task_dta, uint32_t time_us, uint32_t release_us)
+{
+	uint32_t bin;
+
+	p_task_dta->cnt++;
+	p_task_dta->sum += time_us;
+
+	if (p_task_dta->WCET < time_us)
+	{
+		p_task_dta->WCET = time_us;
+	}
+	if (p_task_dta->BCET > time_us)
+	{
+		p_task_dta->BCET = time_us;
+	}
+
+	/* Bin 0 holds 0 uS, bin n holds [2^(n-1), 2^n) uS, the last one the rest */
+	bin = 32 - __CLZ(time_us);
+	if (TASK_X_HIST_QTY <= bin)
+	{
+		bin = TASK_X_HIST_QTY - 1;
+	}
+	p_task_dta->hist[bin]++;
+
+	p_task_dta->jitter_sum += release_us;
+	if (p_task_dta->jitter_max < release_us)
+	{
+		p_task_dta->jitter_max = release_us;
+	}
+}
+
+/* Sleeps until there is something to do; returns with interrupts enabled */
+void app_idle(void)
+{
+#if (APP_IDLE_NONE != APP_IDLE_MODE)
+	uint32_t ticks = 0;
+
+	/* Interrupts stay masked from the check to WFI, a pending one still wakes the core */
+	__asm("CPSID i");	/* disable interrupts */
+	if (G_APP_TICK_CNT_INI < g_app_tick_cnt)
+	{
+		__asm("CPSIE i");	/* enable interrupts */
+		return;
+	}
+
+#if (APP_IDLE_TICKLESS == APP_IDLE_MODE)
+	if ((true == task_sensor_idle()) && (true == task_keypad_idle()) &&
+		(true == task_menu_idle()) && (true == task_display_idle()))
+	{
+		ticks = APP_TICKLESS_MAX_TICKS;
+	}
+#endif
+
+#if (1 == APP_IDLE_SLEEP_ON_EXIT)
+	/* Cleared by HAL_SYSTICK_Callback() so that only a tick resumes the loop */
+	SCB->SCR |= SCB_SCR_SLEEPONEXIT_Msk;
+#endif
+
+	g_app_sleep_cnt++;
+	if (1 < ticks)
+	{
+		g_app_tickless_cnt += app_tickless_sleep(ticks);
+	}
+	else
+	{
+		__DSB();
+		__WFI();
+	}
+	__asm("CPSIE i");	/* enable interrupts */
+#endif
+}
+
+/* Stretches the SysTick period to 'ticks', sleeps and restores the tick grid.
+ * Called with interrupts disabled; returns the tick interrupts skipped */
+uint32_t app_tickless_sleep(uint32_t ticks)
+{
+	uint32_t period = app_tick_reload + 1;
+	uint32_t ctrl;
+	uint32_t remaining;
+	uint32_t reload;
+	uint32_t elapsed;
+	uint32_t done;
+
+	if (true == app_tick_reload_pending)
+	{
+		/* The previous short tick is still running, LOAD is not the period */
+		__DSB();
+		__WFI();
+		return 0;
+	}
+
+	if (SysTick_LOAD_RELOAD_Msk / period < ticks)
+	{
+		ticks = SysTick_LOAD_RELOAD_Msk / period;
+	}
+
+	/* Stop SysTick and extend the current tick by ticks - 1 periods */
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	remaining = SysTick->VAL;
+	if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) || (0 == remaining))
+	{
+		/* A tick is already due */
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return 0;
+	}
+	reload = remaining + (ticks - 1) * period;
+	SysTick->LOAD = reload - 1;
+	SysTick->VAL = 0;
+	(void)SysTick->CTRL;	/* clear COUNTFLAG */
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	__DSB();
+	__WFI();
+
+	/* SysTick or any other interrupt woke the core; reading CTRL clears COUNTFLAG */
+	ctrl = SysTick->CTRL;
+	SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+	if (ctrl & SysTick_CTRL_COUNTFLAG_Msk)
+	{
+		elapsed = reload + (reload - SysTick->VAL);
+	}
+	else
+	{
+		elapsed = reload - SysTick->VAL;
+	}
+
+	/* Realign to the tick grid */
+	if (elapsed < remaining)
+	{
+		done = 0;
+		remaining -= elapsed;
+	}
+	else
+	{
+		elapsed -= remaining;
+		done = 1 + elapsed / period;
+		remaining = period - elapsed % period;
+	}
+	if (1 >= remaining)
+	{
+		/* On the boundary, a zero reload would stop SysTick */
+		done++;
+		remaining = period;
+	}
+	/* LOAD is only written while SysTick is stopped; the nominal period is
+	 * restored by HAL_SYSTICK_Callback() once this short tick has ended */
+	SysTick->LOAD = remaining - 1;
+	SysTick->VAL = 0;
+	(void)SysTick->CTRL;	/* clear COUNTFLAG */
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	app_tick_reload_pending = true;
+
+	if (0 == done)
+	{
+		return 0;
+	}
+
+	/* The pending SysTick interrupt accounts for one tick, the HAL time base
+	 * gets the rest; tasks were idle, so they see a single frame */
+	SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+	uwTick += (done - 1) * uwTickFreq;
+
+	return done - 1;
 }
 
 void HAL_SYSTICK_Callback(void)
 {
-	/* Update Tick Counter */
-	g_app_tick_cnt++;
+#if (1 == APP_IDLE_SLEEP_ON_EXIT)
+	SCB->SCR &= ~SCB_SCR_SLEEPONEXIT_Msk;
+#endif
+
+	/* The realigning tick of app_tickless_sleep() has ended, back to the
+	 * nominal period; the grid slips by the interrupt latency */
+	if ((true == app_tick_reload_pending) && (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk))
+	{
+		SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+		SysTick->LOAD = app_tick_reload;
+		SysTick->VAL = 0;
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		app_tick_reload_pending = false;
+	}
 
-	g_task_sensor_tick_cnt++;
-	g_task_menu_tick_cnt++;
+	/* Extend the cycle counter to 64 bits */
+	dwt_update();
+
+	/* Update Tick Counter, task ticks are posted by app_update() on release */
+	if (APP_TICK_BACKLOG_MAX > g_app_tick_cnt)
+	{
+		g_app_tick_cnt++;
+	}
+	else
+	{
+		g_app_skip_cnt++;
+	}
 }
 
 /********************** end of file ******************************************/
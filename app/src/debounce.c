@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023 Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : debounce.c
+ * @date   : Set 26, 2023
+ * @author : Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes */
+#include "main.h"
+
+/* Application & Tasks includes */
+#include "debounce.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+/* Writes tick_max into the bit planes of 'lanes', the other lanes keep theirs */
+void debounce_tick_max_set(uint16_t *p_tick_max, uint32_t bits, uint16_t lanes, uint32_t tick_max)
+{
+	uint32_t bit;
+
+	for (bit = 0; bits > bit; bit++)
+	{
+		if (0 != (tick_max & (1ul << bit)))
+		{
+			p_tick_max[bit] |= lanes;
+		}
+		else
+		{
+			p_tick_max[bit] &= (uint16_t)~lanes;
+		}
+	}
+}
+
+/* One sample of every lane; returns the lanes whose state toggled */
+uint16_t debounce_update(uint16_t *p_state, uint16_t *p_count, const uint16_t *p_tick_max, uint32_t bits, uint16_t sample)
+{
+	uint32_t bit;
+	uint16_t delta;
+	uint16_t carry;
+	uint16_t match;
+	uint16_t count;
+
+	delta = sample ^ *p_state;
+
+	/* Lanes that agree with the debounced state restart, the others count */
+	carry = delta;
+	match = delta;
+	for (bit = 0; bits > bit; bit++)
+	{
+		count = p_count[bit] & delta;
+
+		p_count[bit] = count ^ carry;
+		carry &= count;
+
+		/* Lanes whose count reached their tick_max */
+		match &= (uint16_t)~(p_count[bit] ^ p_tick_max[bit]);
+	}
+
+	if (0 == match)
+	{
+		return 0;
+	}
+
+	/* Stable long enough: toggle and restart those lanes */
+	for (bit = 0; bits > bit; bit++)
+	{
+		p_count[bit] &= (uint16_t)~match;
+	}
+	*p_state ^= match;
+
+	return match;
+}
+
+/* True while any lane is counting */
+bool debounce_counting(const uint16_t *p_count, uint32_t bits)
+{
+	uint32_t bit;
+	uint16_t count = 0;
+
+	for (bit = 0; bits > bit; bit++)
+	{
+		count |= p_count[bit];
+	}
+	return (0 != count);
+}
+
+/********************** end of file ******************************************/
@@ -4,7 +4,9 @@
 
 #include "display.h"
 #include "main.h"
+#include "board.h"
 #include <stdbool.h>
+#include <string.h>
 
 /* Demo includes */
 #include "logger.h"
@@ -34,6 +36,7 @@
 #define DISPLAY_IR_ENTRY_MODE_SET  0b00000100
 #define DISPLAY_IR_DISPLAY_CONTROL 0b00001000
 #define DISPLAY_IR_FUNCTION_SET    0b00100000
+#define DISPLAY_IR_SET_CGRAM_ADDR  0b01000000
 #define DISPLAY_IR_SET_DDRAM_ADDR  0b10000000
 
 #define DISPLAY_IR_ENTRY_MODE_SET_INCREMENT 0b00000010
@@ -60,28 +63,146 @@
 #define DISPLAY_20x4_LINE3_FIRST_CHARACTER_ADDRESS 20
 #define DISPLAY_20x4_LINE4_FIRST_CHARACTER_ADDRESS 84
 
+#define DISPLAY_20x4_COLUMNS DISPLAY_COLUMNS
+#define DISPLAY_20x4_ROWS    DISPLAY_ROWS
+
+// The controller's address counter is not known (after CGRAM writes)
+#define DISPLAY_ADDRESS_UNKNOWN 0xFF
+
+// Bar widget: glyphs DISPLAY_BAR_GLYPH_FIRST.. hold 1..4 lit columns, a
+// fully lit cell is the ROM block character
+#define DISPLAY_BAR_GLYPH_FIRST     0
+#define DISPLAY_BAR_CELL_COLUMNS    5
+#define DISPLAY_BAR_FULL_CHAR       ( (char)0xFF )
+
+// Unchanged cells this short between two changed runs are rewritten rather
+// than paying for another DDRAM address command
+#define DISPLAY_FLUSH_MAX_GAP 1
+
 #define DISPLAY_RS_INSTRUCTION 0
 #define DISPLAY_RS_DATA        1
 
 #define DISPLAY_RW_WRITE 0
 #define DISPLAY_RW_READ  1
 
-#define DISPLAY_PIN_RS  4
-#define DISPLAY_PIN_RW  5
-#define DISPLAY_PIN_EN  6
-#define DISPLAY_PIN_D0  7
-#define DISPLAY_PIN_D1  8
-#define DISPLAY_PIN_D2  9
-#define DISPLAY_PIN_D3 10
-#define DISPLAY_PIN_D4 11
-#define DISPLAY_PIN_D5 12
-#define DISPLAY_PIN_D6 13
-#define DISPLAY_PIN_D7 14
-
 #define DISPLAY_DEL_37US	37ul
 #define DISPLAY_DEL_01US	01ul
+#define DISPLAY_DEL_1520US	1520ul
+#define DISPLAY_DEL_4100US	4100ul
+
+// Wait from displayInit() to the first command, Vcc rise time included
+#define DISPLAY_POWER_ON_MS     50ul
+
+// Write engine: bus words queued by the application, clocked out by TIM4
+#define DISPLAY_TIM                 TIM4
+#define DISPLAY_TIM_IRQn            TIM4_IRQn
+#define DISPLAY_TIM_IRQ_PRIORITY    1
+#define DISPLAY_TIM_TICK_HZ         1000000ul
+
+#define DISPLAY_RING_SIZE   256     // Must be a power of two
+#define DISPLAY_RING_MASK   ( DISPLAY_RING_SIZE - 1 )
+
+// Ring words of a code on a 4-bit bus, two nibbles. displayFlush() leaves
+// what does not fit dirty instead of waiting for the ring to drain
+#define DISPLAY_RING_CODE_WORDS 2
+
+// Bus word: D7..D0 (bits 7..0), RS (bit 8), post-strobe delay (bits 13..12)
+#define DISPLAY_BUS_DATA_MASK   0x00FFu
+#define DISPLAY_BUS_RS          0x0100u
+#define DISPLAY_BUS_DELAY_POS   12
+#define DISPLAY_BUS_DELAY_MASK  0x3000u
+
+// Busy flag polling: interval between reads. Every read strobes EN, so RW
+// must be wired: with RW low the strobe would write 0xFF as an instruction
+#define DISPLAY_BF_POLL_US      4ul
+
+// Bus timing for reads, rounded up for 3.3 V modules
+#define DISPLAY_TAS_NS          60ul    // RS/RW setup to EN
+#define DISPLAY_TPW_NS          500ul   // EN pulse width, data valid (tDDR)
+
+// GPIO ports the data and RS pins can spread over (GPIOA..GPIOE)
+#define DISPLAY_BUS_PORTS_MAX   5
+
+// I2C transport: PCF8574 outputs P0..P7 drive RS, RW, EN, backlight, D4..D7
+#define DISPLAY_I2C             I2C1
+#define DISPLAY_I2C_EV_IRQn     I2C1_EV_IRQn
+#define DISPLAY_I2C_ER_IRQn     I2C1_ER_IRQn
+#define DISPLAY_I2C_DMA         DMA1_Channel6   // I2C1_TX request
+#define DISPLAY_I2C_DMA_IRQn    DMA1_Channel6_IRQn
+#define DISPLAY_I2C_DMA_TC      DMA_ISR_TCIF6
+#define DISPLAY_I2C_DMA_CLEAR   DMA_IFCR_CGIF6
+#define DISPLAY_I2C_IRQ_PRIORITY 1
+#define DISPLAY_I2C_CLOCK_HZ    100000ul        // PCF8574 limit
+
+#define DISPLAY_PCF8574_RS      0x01
+#define DISPLAY_PCF8574_RW      0x02
+#define DISPLAY_PCF8574_EN      0x04
+#define DISPLAY_PCF8574_BL      0x08
+
+// A byte with its ACK takes 9 SCL periods. That covers the 37 us delays,
+// the longer ones are padded with bytes that leave EN low
+#define DISPLAY_I2C_BYTE_US     ( 9ul * 1000000ul / DISPLAY_I2C_CLOCK_HZ )
+
+// Three bytes per nibble, two nibbles per code: a whole screen, or all
+// eight glyphs, per transfer. displayFlush() leaves what does not fit dirty
+#define DISPLAY_I2C_BUFFER_SIZE 1024
+
+// Buffer bytes of a code with the 37 us delay: two 3-byte nibbles, padded
+#define DISPLAY_I2C_CODE_BYTES  ( 2 * 3 + DISPLAY_DEL_37US / DISPLAY_I2C_BYTE_US )
 
 //=====[Declaration of private data types]=====================================
+typedef enum {
+    DISPLAY_DELAY_01US,
+    DISPLAY_DELAY_37US,
+    DISPLAY_DELAY_1520US,
+    DISPLAY_DELAY_4100US,
+} displayDelay_t;
+
+typedef enum {
+    DISPLAY_INIT_POWER_ON,      // Waiting for Vcc to settle
+    DISPLAY_INIT_SEQUENCE,      // Init commands queued, engine draining them
+    DISPLAY_INIT_READY,
+} displayInitState_t;
+
+typedef struct {
+    volatile uint16_t ring[DISPLAY_RING_SIZE];
+    volatile uint32_t head;     // Written by the application only
+    volatile uint32_t tail;     // Written by the timer ISR only
+    volatile bool busy;         // Timer running, cleared by the ISR when idle
+    bool enableHigh;            // ISR phase: EN raised, waiting to drop it
+    bool polling;               // ISR phase: reading the busy flag
+    displayDelay_t delay;       // Post-strobe delay of the latched word
+    uint32_t strobeEnd;         // CYCCNT when EN dropped
+    bool pollBusyFlag;          // Busy flag mode active
+} displayEngine_t;
+
+typedef struct {
+    GPIO_TypeDef *port;
+    uint16_t pin;
+} displayPin_t;
+
+// BSRR images of one GPIO port: each nibble value sets its pins and resets
+// the others, so a bus word costs one store per port
+typedef struct {
+    GPIO_TypeDef *port;
+    uint32_t nibbleHigh[16];    // D7..D4
+    uint32_t nibbleLow[16];     // D3..D0, zero in 4-bit mode
+    uint32_t rs[2];             // DISPLAY_RS_INSTRUCTION, DISPLAY_RS_DATA
+    uint32_t dataPins;          // Data pins on this port
+    uint32_t crMask[2];         // CRL, CRH fields of the data pins
+    uint32_t crInput[2];        // Input with pull-up
+    uint32_t crOutput[2];       // As configured at init
+} displayBusPort_t;
+
+// One I2C write of the whole buffer, filled while no transfer is running
+typedef struct {
+    uint8_t buffer[DISPLAY_I2C_BUFFER_SIZE];
+    uint16_t length;
+    volatile bool busy;         // Cleared by the ISRs after STOP
+    volatile bool dmaDone;      // Last byte handed to the I2C, waiting for BTF
+    uint32_t overflowCnt;       // Codes dropped for lack of room
+    uint32_t errorCnt;          // Transfers aborted by a NACK or bus error
+} displayI2c_t;
 
 //=====[Declaration and initialization of public global objects]===============
 
@@ -103,51 +224,450 @@ DigitalOut displayEn( D9 );
 //=====[Declaration and initialization of private global variables]============
 static display_t display;
 static bool initial8BitCommunicationIsCompleted;
+static displayEngine_t displayEngine;
+static displayI2c_t displayI2c;
+static displayInitState_t displayInitState;
+static uint32_t displayInitTick;
+
+// Shadow of the DDRAM: frame being drawn and frame the controller shows
+static char displayFrame[DISPLAY_20x4_ROWS][DISPLAY_20x4_COLUMNS];
+static char displayCommitted[DISPLAY_20x4_ROWS][DISPLAY_20x4_COLUMNS];
+static uint8_t displayCursorX;
+static uint8_t displayCursorY;
+static uint8_t displayRowDirty;     // Rows written since the last flush
+static uint8_t displayAddressCounter;   // DDRAM address the next data write lands on
+
+static const uint8_t displayLineAddress[DISPLAY_20x4_ROWS] = {
+    DISPLAY_20x4_LINE1_FIRST_CHARACTER_ADDRESS,
+    DISPLAY_20x4_LINE2_FIRST_CHARACTER_ADDRESS,
+    DISPLAY_20x4_LINE3_FIRST_CHARACTER_ADDRESS,
+    DISPLAY_20x4_LINE4_FIRST_CHARACTER_ADDRESS,
+};
+
+// Rows in DDRAM order: the end of line 1 runs into line 3, and 2 into 4
+static const uint8_t displayFlushOrder[DISPLAY_20x4_ROWS] = { 0, 2, 1, 3 };
+
+// CGRAM cache: bitmaps last loaded, and which of them the controller holds
+static uint8_t displayGlyphs[DISPLAY_GLYPH_QTY][DISPLAY_GLYPH_ROWS];
+static uint8_t displayGlyphResident;
+static uint8_t displayGlyphPending;
+
+static const displayPin_t displayDataPins[8] = {
+    { DISPLAY_D0_PORT, DISPLAY_D0_PIN },
+    { DISPLAY_D1_PORT, DISPLAY_D1_PIN },
+    { DISPLAY_D2_PORT, DISPLAY_D2_PIN },
+    { DISPLAY_D3_PORT, DISPLAY_D3_PIN },
+    { DISPLAY_D4_PORT, DISPLAY_D4_PIN },
+    { DISPLAY_D5_PORT, DISPLAY_D5_PIN },
+    { DISPLAY_D6_PORT, DISPLAY_D6_PIN },
+    { DISPLAY_D7_PORT, DISPLAY_D7_PIN },
+};
+
+#if ( DISPLAY_USE_BUSY_FLAG == 1 )
+static const displayPin_t displayRwPin = { DISPLAY_RW_PORT, DISPLAY_RW_PIN };
+#endif
+
+static displayBusPort_t displayBusPorts[DISPLAY_BUS_PORTS_MAX];
+static uint8_t displayBusPortQty;
+
+static const uint16_t displayDelayUs[] = {
+    DISPLAY_DEL_01US,
+    DISPLAY_DEL_37US,
+    DISPLAY_DEL_1520US,
+    DISPLAY_DEL_4100US,
+};
 
 //=====[Declarations (prototypes) of private functions]========================
-static void displayPinWrite( uint8_t pinName, int value );
-static void displayDataBusWrite( uint8_t dataByte );
+static void displayPinOutputInit( const displayPin_t *pin );
+#if ( DISPLAY_USE_BUSY_FLAG == 1 )
+static void displayDataBusDirection( bool input );
+static bool displayBusyFlagRead( void );
+static void displayDelayNs( uint32_t delay_ns );
+#endif
+static displayBusPort_t *displayBusPortGet( GPIO_TypeDef *port );
+static void displayBusTableBuild( void );
+static void displayInitSequenceWrite( void );
 static void displayCodeWrite( bool type, uint8_t dataBus );
+static void displayCodeDelayWrite( bool type, uint8_t dataBus, displayDelay_t delay );
+static void displayDdramAddressWrite( uint8_t charPositionX, uint8_t charPositionY );
+static void displayRunWrite( uint8_t row, uint8_t first, uint8_t last );
+static void displayCellsWrite( uint8_t charPositionX, uint8_t charPositionY,
+                               const char *cells, uint8_t length );
+static void displayGlyphUpload( uint8_t glyph );
+static void displayBarGlyphsLoad( void );
+static bool displayBusRoom( uint32_t codes );
+static void displayBusWordPut( uint16_t busWord );
+static void displayBusWordWrite( uint16_t busWord );
+static void displayTimerInit( void );
+static void displayTimerStart( uint32_t delay_us );
+static void displayI2cInit( void );
+static void displayI2cWordPut( uint16_t busWord );
+static void displayI2cTransferStart( void );
+static void displayI2cTransferEnd( void );
 
 //=====[Implementations of public functions]===================================
 void displayInit( displayConnection_t connection )
 {
+    uint8_t bit;
+
     display.connection = connection;
 
     initial8BitCommunicationIsCompleted = false;
 
-    HAL_Delay(50);
+    displayEngine.head = 0;
+    displayEngine.tail = 0;
+    displayEngine.busy = false;
+    displayEngine.enableHigh = false;
+    displayEngine.polling = false;
+    displayEngine.pollBusyFlag = false;
 
-    displayCodeWrite( DISPLAY_RS_INSTRUCTION,
-                      DISPLAY_IR_FUNCTION_SET |
-                      DISPLAY_IR_FUNCTION_SET_8BITS );
-    HAL_Delay(5);
+    if ( connection == DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER ) {
+        displayI2cInit();
+    } else {
+        displayTimerInit();
 
-    displayCodeWrite( DISPLAY_RS_INSTRUCTION,
-                      DISPLAY_IR_FUNCTION_SET |
-                      DISPLAY_IR_FUNCTION_SET_8BITS );
-    HAL_Delay(1);
+        // D4..D7, RS and EN are set up by MX_GPIO_Init(), D0..D3 and RW only when used
+        if ( connection == DISPLAY_CONNECTION_GPIO_8BITS ) {
+            for ( bit = 0; bit < 4; bit++ ) {
+                displayPinOutputInit( &displayDataPins[bit] );
+            }
+        }
+#if ( DISPLAY_USE_BUSY_FLAG == 1 )
+        displayPinOutputInit( &displayRwPin );
+#endif
+        displayBusTableBuild();
+    }
+
+    // The clear command of the init sequence leaves the DDRAM filled with spaces
+    memset( displayFrame, ' ', sizeof(displayFrame) );
+    memset( displayCommitted, ' ', sizeof(displayCommitted) );
+    displayCursorX = 0;
+    displayCursorY = 0;
+    displayRowDirty = 0;
+    displayAddressCounter = DISPLAY_ADDRESS_UNKNOWN;
+
+    // CGRAM content is undefined at power-on
+    displayGlyphResident = 0;
+    displayGlyphPending = 0;
+
+    // The controller is brought up by displayUpdate(), nothing waits here
+    displayInitState = DISPLAY_INIT_POWER_ON;
+    displayInitTick = HAL_GetTick();
+}
+
+void displayUpdate( void )
+{
+    switch( displayInitState ) {
+        case DISPLAY_INIT_POWER_ON:
+            // Vcc must have been stable for 40 ms before the first command
+            if ( ( HAL_GetTick() - displayInitTick ) >= DISPLAY_POWER_ON_MS ) {
+                displayInitSequenceWrite();
+                displayI2cTransferStart();
+                displayInitState = DISPLAY_INIT_SEQUENCE;
+            }
+        break;
+
+        case DISPLAY_INIT_SEQUENCE:
+            if ( !displayBusy() ) {
+                // The busy flag is valid once the interface length is set
+                displayEngine.pollBusyFlag = ( DISPLAY_USE_BUSY_FLAG == 1 ) &&
+                    ( display.connection != DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER );
+                displayInitState = DISPLAY_INIT_READY;
+            }
+        break;
+
+        case DISPLAY_INIT_READY:
+        break;
+    }
+}
+
+bool displayReady( void )
+{
+    return ( displayInitState == DISPLAY_INIT_READY );
+}
+
+void displayCharPositionWrite( uint8_t charPositionX, uint8_t charPositionY )
+{
+    displayCursorX = charPositionX;
+    displayCursorY = charPositionY;
+}
+
+void displayStringWrite( const char * str )
+{
+    displayCellsWrite( displayCursorX, displayCursorY, str, strlen( str ) );
+}
+
+void displayRegionWrite( uint8_t charPositionX, uint8_t charPositionY,
+                         const char *buffer, uint8_t length )
+{
+    displayCellsWrite( charPositionX, charPositionY, buffer, length );
+}
+
+void displayScreenWrite( const char *screen )
+{
+    uint8_t row;
+
+    for ( row = 0; row < DISPLAY_20x4_ROWS; row++ ) {
+        displayCellsWrite( 0, row, &screen[row * DISPLAY_20x4_COLUMNS], DISPLAY_20x4_COLUMNS );
+    }
+}
+
+void displayGlyphLoad( uint8_t glyph, const uint8_t *bitmap )
+{
+    uint8_t mask = 1 << glyph;
+
+    if ( glyph >= DISPLAY_GLYPH_QTY ) {
+        return;
+    }
+
+    // Already loaded with this bitmap, sent or about to be
+    if ( ( ( displayGlyphResident | displayGlyphPending ) & mask ) &&
+         ( memcmp( displayGlyphs[glyph], bitmap, DISPLAY_GLYPH_ROWS ) == 0 ) ) {
+        return;
+    }
+
+    memcpy( displayGlyphs[glyph], bitmap, DISPLAY_GLYPH_ROWS );
+    displayGlyphResident &= ~mask;
+    displayGlyphPending |= mask;
+}
+
+void displayBarWrite( uint8_t charPositionX, uint8_t charPositionY,
+                      uint8_t width, uint32_t value, uint32_t valueMax )
+{
+    uint32_t columns;
+    uint8_t lit;
+    char *cell;
+    char code;
+
+    if ( ( charPositionY >= DISPLAY_20x4_ROWS ) || ( valueMax == 0 ) ) {
+        return;
+    }
+    if ( value > valueMax ) {
+        value = valueMax;
+    }
+
+    displayBarGlyphsLoad();
+
+    cell = &displayFrame[charPositionY][0];
+    columns = ( value * width * DISPLAY_BAR_CELL_COLUMNS + valueMax / 2 ) / valueMax;
+
+    // Clipped at the end of the line, like strings
+    for ( ; width && ( charPositionX < DISPLAY_20x4_COLUMNS ); width--, charPositionX++ ) {
+        lit = ( columns > DISPLAY_BAR_CELL_COLUMNS ) ? DISPLAY_BAR_CELL_COLUMNS : columns;
+        columns -= lit;
+
+        if ( lit == 0 ) {
+            code = ' ';
+        } else if ( lit == DISPLAY_BAR_CELL_COLUMNS ) {
+            code = DISPLAY_BAR_FULL_CHAR;
+        } else {
+            code = DISPLAY_GLYPH_CHAR( DISPLAY_BAR_GLYPH_FIRST + lit - 1 );
+        }
+
+        if ( cell[charPositionX] != code ) {
+            cell[charPositionX] = code;
+            displayRowDirty |= 1 << charPositionY;
+        }
+    }
+}
+
+void displayFlush( void )
+{
+    uint8_t row, column, first, last;
+    uint8_t glyph, order;
+
+    // The frame stays dirty until the controller, or the I2C buffer, can take it
+    if ( ( displayInitState != DISPLAY_INIT_READY ) || displayI2c.busy ) {
+        return;
+    }
+
+    // Glyphs go first: cells already on screen take the new shape at once
+    for ( glyph = 0; displayGlyphPending; glyph++ ) {
+        if ( displayGlyphPending & ( 1 << glyph ) ) {
+            if ( !displayBusRoom( 1 + DISPLAY_GLYPH_ROWS ) ) {
+                displayI2cTransferStart();
+                return;
+            }
+            displayGlyphUpload( glyph );
+        }
+    }
+
+    for ( order = 0; displayRowDirty && ( order < DISPLAY_20x4_ROWS ); order++ ) {
+        row = displayFlushOrder[order];
+        if ( !( displayRowDirty & ( 1 << row ) ) ) {
+            continue;
+        }
+        displayRowDirty &= ~( 1 << row );
+
+        column = 0;
+        while ( column < DISPLAY_20x4_COLUMNS ) {
+            if ( displayFrame[row][column] == displayCommitted[row][column] ) {
+                column++;
+                continue;
+            }
+
+            // Grow the run, swallowing short stretches of unchanged cells
+            first = column;
+            last = column;
+            for ( column++; column < DISPLAY_20x4_COLUMNS; column++ ) {
+                if ( displayFrame[row][column] != displayCommitted[row][column] ) {
+                    last = column;
+                } else if ( column - last > DISPLAY_FLUSH_MAX_GAP ) {
+                    break;
+                }
+            }
+
+            // Out of ring or I2C buffer: the rest of the frame waits for the next flush
+            if ( !displayBusRoom( 1 + last - first + 1 ) ) {
+                displayRowDirty |= 1 << row;
+                displayI2cTransferStart();
+                return;
+            }
+
+            displayRunWrite( row, first, last );
+        }
+    }
+
+    displayI2cTransferStart();
+}
+
+bool displayBusy( void )
+{
+    return displayEngine.busy || displayI2c.busy;
+}
+
+bool displayDirty( void )
+{
+    return ( displayRowDirty != 0 ) || ( displayGlyphPending != 0 );
+}
+
+void displayTimerIrqHandler( void )
+{
+    uint16_t busWord;
+
+    if ( !( DISPLAY_TIM->SR & TIM_SR_UIF ) ) {
+        return;
+    }
+    DISPLAY_TIM->SR = ~(uint32_t)TIM_SR_UIF;
+
+    // Second half of a strobe: drop EN and hold off for the word's delay,
+    // or poll the busy flag during it
+    if ( displayEngine.enableHigh ) {
+        DISPLAY_EN_PORT->BSRR = (uint32_t)DISPLAY_EN_PIN << 16;
+        displayEngine.enableHigh = false;
+
+        if ( displayEngine.pollBusyFlag &&
+             ( displayEngine.delay != DISPLAY_DELAY_01US ) ) {
+            displayEngine.polling = true;
+            displayEngine.strobeEnd = DWT->CYCCNT;
+            displayTimerStart( DISPLAY_BF_POLL_US );
+        } else {
+            displayTimerStart( displayDelayUs[displayEngine.delay] );
+        }
+        return;
+    }
+
+#if ( DISPLAY_USE_BUSY_FLAG == 1 )
+    if ( displayEngine.polling ) {
+        uint32_t delayCycles = displayDelayUs[displayEngine.delay] *
+                               ( SystemCoreClock / 1000000ul );
+        bool expired = dwt_elapsed32( displayEngine.strobeEnd ) >= delayCycles;
+
+        // The fixed delay still bounds the wait if the flag sticks
+        if ( displayBusyFlagRead() && !expired ) {
+            displayTimerStart( DISPLAY_BF_POLL_US );
+            return;
+        }
+        displayEngine.polling = false;
+    }
+#endif
+
+    if ( displayEngine.tail == displayEngine.head ) {
+        displayEngine.busy = false;
+        return;
+    }
+
+    busWord = displayEngine.ring[displayEngine.tail];
+    displayEngine.tail = ( displayEngine.tail + 1 ) & DISPLAY_RING_MASK;
+
+    displayBusWordWrite( busWord );
+    displayEngine.delay = (displayDelay_t)
+        ( ( busWord & DISPLAY_BUS_DELAY_MASK ) >> DISPLAY_BUS_DELAY_POS );
+    displayEngine.enableHigh = true;
+    displayTimerStart( DISPLAY_DEL_01US );
+}
+
+void displayI2cEventIrqHandler( void )
+{
+    uint32_t sr1 = DISPLAY_I2C->SR1;
+
+    // Start sent: address the expander for a write
+    if ( sr1 & I2C_SR1_SB ) {
+        DISPLAY_I2C->DR = DISPLAY_I2C_ADDRESS << 1;
+        return;
+    }
+
+    // Address acknowledged: reading SR2 releases the bus to the DMA
+    if ( sr1 & I2C_SR1_ADDR ) {
+        (void)DISPLAY_I2C->SR2;
+        return;
+    }
+
+    // Last byte shifted out after the DMA delivered it
+    if ( ( sr1 & I2C_SR1_BTF ) && displayI2c.dmaDone ) {
+        displayI2cTransferEnd();
+    }
+}
+
+void displayI2cErrorIrqHandler( void )
+{
+    DISPLAY_I2C->SR1 &= ~( I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR );
+    displayI2c.errorCnt++;
+    displayI2cTransferEnd();
+}
+
+void displayI2cDmaIrqHandler( void )
+{
+    if ( DMA1->ISR & DISPLAY_I2C_DMA_TC ) {
+        DMA1->IFCR = DISPLAY_I2C_DMA_CLEAR;
+        displayI2c.dmaDone = true;
+    }
+}
+
+//=====[Implementations of private functions]==================================
+static void displayInitSequenceWrite( void )
+{
+    // Wake-up: three 8-bit function sets, whatever mode the controller was in
+    displayCodeDelayWrite( DISPLAY_RS_INSTRUCTION,
+                           DISPLAY_IR_FUNCTION_SET |
+                           DISPLAY_IR_FUNCTION_SET_8BITS,
+                           DISPLAY_DELAY_4100US );
+
+    displayCodeDelayWrite( DISPLAY_RS_INSTRUCTION,
+                           DISPLAY_IR_FUNCTION_SET |
+                           DISPLAY_IR_FUNCTION_SET_8BITS,
+                           DISPLAY_DELAY_1520US );
 
     displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                       DISPLAY_IR_FUNCTION_SET |
                       DISPLAY_IR_FUNCTION_SET_8BITS );
-    HAL_Delay(1);
 
     switch( display.connection ) {
         case DISPLAY_CONNECTION_GPIO_8BITS:
+            initial8BitCommunicationIsCompleted = true;
+
             displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                               DISPLAY_IR_FUNCTION_SET |
                               DISPLAY_IR_FUNCTION_SET_8BITS |
                               DISPLAY_IR_FUNCTION_SET_2LINES |
                               DISPLAY_IR_FUNCTION_SET_5x8DOTS );
-            HAL_Delay(1);
         break;
 
         case DISPLAY_CONNECTION_GPIO_4BITS:
+        case DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER:
             displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                               DISPLAY_IR_FUNCTION_SET |
                               DISPLAY_IR_FUNCTION_SET_4BITS );
-            HAL_Delay(1);
 
             initial8BitCommunicationIsCompleted = true;
 
@@ -156,7 +676,6 @@ void displayInit( displayConnection_t connection )
                               DISPLAY_IR_FUNCTION_SET_4BITS |
                               DISPLAY_IR_FUNCTION_SET_2LINES |
                               DISPLAY_IR_FUNCTION_SET_5x8DOTS );
-            HAL_Delay(1);
         break;
     }
 
@@ -165,27 +684,61 @@ void displayInit( displayConnection_t connection )
                       DISPLAY_IR_DISPLAY_CONTROL_DISPLAY_OFF |
                       DISPLAY_IR_DISPLAY_CONTROL_CURSOR_OFF |
                       DISPLAY_IR_DISPLAY_CONTROL_BLINK_OFF );
-    HAL_Delay(1);
 
     displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                       DISPLAY_IR_CLEAR_DISPLAY );
-    HAL_Delay(1);
+    displayAddressCounter = DISPLAY_20x4_LINE1_FIRST_CHARACTER_ADDRESS;
 
     displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                       DISPLAY_IR_ENTRY_MODE_SET |
                       DISPLAY_IR_ENTRY_MODE_SET_INCREMENT |
                       DISPLAY_IR_ENTRY_MODE_SET_NO_SHIFT );
-    HAL_Delay(1);
 
     displayCodeWrite( DISPLAY_RS_INSTRUCTION,
                       DISPLAY_IR_DISPLAY_CONTROL |
                       DISPLAY_IR_DISPLAY_CONTROL_DISPLAY_ON |
                       DISPLAY_IR_DISPLAY_CONTROL_CURSOR_OFF |
                       DISPLAY_IR_DISPLAY_CONTROL_BLINK_OFF );
-    HAL_Delay(1);
 }
 
-void displayCharPositionWrite( uint8_t charPositionX, uint8_t charPositionY )
+static void displayCodeWrite( bool type, uint8_t dataBus )
+{
+    displayDelay_t delay = DISPLAY_DELAY_37US;
+
+    // Clear display and return home need 1.52 ms instead of 37 us
+    if ( ( type == DISPLAY_RS_INSTRUCTION ) && ( dataBus < 0b00000100 ) ) {
+        delay = DISPLAY_DELAY_1520US;
+    }
+
+    displayCodeDelayWrite( type, dataBus, delay );
+}
+
+static void displayCodeDelayWrite( bool type, uint8_t dataBus, displayDelay_t delay )
+{
+    uint16_t rs = ( type == DISPLAY_RS_DATA ) ? DISPLAY_BUS_RS : 0;
+
+    switch( display.connection ) {
+        case DISPLAY_CONNECTION_GPIO_8BITS:
+            displayBusWordPut( rs | dataBus |
+                               ( delay << DISPLAY_BUS_DELAY_POS ) );
+        break;
+
+        case DISPLAY_CONNECTION_GPIO_4BITS:
+        case DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER:
+            if ( initial8BitCommunicationIsCompleted == true) {
+                displayBusWordPut( rs | ( dataBus & 0xF0 ) |
+                                   ( DISPLAY_DELAY_01US << DISPLAY_BUS_DELAY_POS ) );
+                displayBusWordPut( rs | ( ( dataBus << 4 ) & 0xF0 ) |
+                                   ( delay << DISPLAY_BUS_DELAY_POS ) );
+            } else {
+                displayBusWordPut( rs | ( dataBus & 0xF0 ) |
+                                   ( delay << DISPLAY_BUS_DELAY_POS ) );
+            }
+        break;
+    }
+}
+
+static void displayDdramAddressWrite( uint8_t charPositionX, uint8_t charPositionY )
 {
     switch( charPositionY ) {
         case 0:
@@ -222,105 +775,408 @@ void displayCharPositionWrite( uint8_t charPositionX, uint8_t charPositionY )
     }
 }
 
-void displayStringWrite( const char * str )
+static void displayRunWrite( uint8_t row, uint8_t first, uint8_t last )
 {
-    while (*str) {
-    	displayCodeWrite(DISPLAY_RS_DATA, *str++);
+    uint8_t column;
+    uint8_t address = displayLineAddress[row] + last;
+
+    // Auto-increment may have left the address counter right here
+    if ( displayAddressCounter != displayLineAddress[row] + first ) {
+        displayDdramAddressWrite( first, row );
+    }
+
+    for ( column = first; column <= last; column++ ) {
+        displayCodeWrite( DISPLAY_RS_DATA, displayFrame[row][column] );
+        displayCommitted[row][column] = displayFrame[row][column];
+    }
+
+    // In 2-line mode the counter wraps from 0x27 to 0x40 and from 0x67 to 0x00
+    if ( address == 0x27 ) {
+        displayAddressCounter = 0x40;
+    } else if ( address == 0x67 ) {
+        displayAddressCounter = 0x00;
+    } else {
+        displayAddressCounter = address + 1;
     }
 }
 
-//=====[Implementations of private functions]==================================
-static void displayCodeWrite( bool type, uint8_t dataBus )
+static void displayCellsWrite( uint8_t charPositionX, uint8_t charPositionY,
+                               const char *cells, uint8_t length )
 {
-	if ( type == DISPLAY_RS_INSTRUCTION )
-		displayPinWrite( DISPLAY_PIN_RS, DISPLAY_RS_INSTRUCTION );
-	else
-		displayPinWrite( DISPLAY_PIN_RS, DISPLAY_RS_DATA );
+    char *cell;
 
-	displayPinWrite( DISPLAY_PIN_RW, DISPLAY_RW_WRITE );
-	displayDataBusWrite( dataBus );
-    systick_delay_us(DISPLAY_DEL_37US);
+    if ( charPositionY >= DISPLAY_20x4_ROWS ) {
+        return;
+    }
 
+    cell = &displayFrame[charPositionY][0];
+
+    // Text past the end of the line is clipped
+    while ( length && ( charPositionX < DISPLAY_20x4_COLUMNS ) ) {
+        if ( cell[charPositionX] != *cells ) {
+            cell[charPositionX] = *cells;
+            displayRowDirty |= 1 << charPositionY;
+        }
+        charPositionX++;
+        cells++;
+        length--;
+    }
+
+    displayCursorX = charPositionX;
+    displayCursorY = charPositionY;
 }
 
-static void displayPinWrite( uint8_t pinName, int value )
+static void displayGlyphUpload( uint8_t glyph )
 {
-    switch( display.connection ) {
-    	case DISPLAY_CONNECTION_GPIO_8BITS:
-            switch( pinName ) {
-            	/*
-                case DISPLAY_PIN_D0: displayD0 = value;   break;
-                case DISPLAY_PIN_D1: displayD1 = value;   break;
-                case DISPLAY_PIN_D2: displayD2 = value;   break;
-                case DISPLAY_PIN_D3: displayD3 = value;   break;
-                case DISPLAY_PIN_D4: displayD4 = value;   break;
-                case DISPLAY_PIN_D5: displayD5 = value;   break;
-                case DISPLAY_PIN_D6: displayD6 = value;   break;
-                case DISPLAY_PIN_D7: displayD7 = value;   break;
-                case DISPLAY_PIN_RS: displayRs = value;   break;
-                case DISPLAY_PIN_EN: displayEn = value;   break;
-                case DISPLAY_PIN_RW: break;
-                */
-                default: break;
-            }
-            break;
+    uint8_t row;
 
-        case DISPLAY_CONNECTION_GPIO_4BITS:
-            switch( pinName ) {
-            	case DISPLAY_PIN_D4: HAL_GPIO_WritePin(D4_GPIO_Port, D4_Pin, value);   break;
-				case DISPLAY_PIN_D5: HAL_GPIO_WritePin(D5_GPIO_Port, D5_Pin, value);   break;
-				case DISPLAY_PIN_D6: HAL_GPIO_WritePin(D6_GPIO_Port, D6_Pin, value);   break;
-				case DISPLAY_PIN_D7: HAL_GPIO_WritePin(D7_GPIO_Port, D7_Pin, value);   break;
-				case DISPLAY_PIN_RS: HAL_GPIO_WritePin(D8_GPIO_Port, D8_Pin, value);   break;
-				case DISPLAY_PIN_EN: HAL_GPIO_WritePin(D9_GPIO_Port, D9_Pin, value);   break;
-                case DISPLAY_PIN_RW: break;
-                default: break;
-            }
-            break;
+    // Leaves the address counter in CGRAM, every run sets a DDRAM address
+    displayCodeWrite( DISPLAY_RS_INSTRUCTION,
+                      DISPLAY_IR_SET_CGRAM_ADDR | ( glyph * DISPLAY_GLYPH_ROWS ) );
+
+    for ( row = 0; row < DISPLAY_GLYPH_ROWS; row++ ) {
+        displayCodeWrite( DISPLAY_RS_DATA, displayGlyphs[glyph][row] );
     }
+
+    displayAddressCounter = DISPLAY_ADDRESS_UNKNOWN;
+    displayGlyphPending &= ~( 1 << glyph );
+    displayGlyphResident |= 1 << glyph;
 }
 
-static void displayDataBusWrite( uint8_t dataBus )
+static void displayBarGlyphsLoad( void )
 {
-    displayPinWrite( DISPLAY_PIN_EN, OFF );
-    displayPinWrite( DISPLAY_PIN_D7, dataBus & 0b10000000 );
-    displayPinWrite( DISPLAY_PIN_D6, dataBus & 0b01000000 );
-    displayPinWrite( DISPLAY_PIN_D5, dataBus & 0b00100000 );
-    displayPinWrite( DISPLAY_PIN_D4, dataBus & 0b00010000 );
+    uint8_t bitmap[DISPLAY_GLYPH_ROWS];
+    uint8_t lit;
 
-    switch( display.connection ) {
-        case DISPLAY_CONNECTION_GPIO_8BITS:
-            displayPinWrite( DISPLAY_PIN_D3, dataBus & 0b00001000 );
-            displayPinWrite( DISPLAY_PIN_D2, dataBus & 0b00000100 );
-            displayPinWrite( DISPLAY_PIN_D1, dataBus & 0b00000010 );
-            displayPinWrite( DISPLAY_PIN_D0, dataBus & 0b00000001 );
-        break;
+    // Left-aligned columns, the cursor row is left blank
+    for ( lit = 1; lit < DISPLAY_BAR_CELL_COLUMNS; lit++ ) {
+        memset( bitmap, ( 0x1F << ( DISPLAY_BAR_CELL_COLUMNS - lit ) ) & 0x1F,
+                DISPLAY_GLYPH_ROWS - 1 );
+        bitmap[DISPLAY_GLYPH_ROWS - 1] = 0;
+        displayGlyphLoad( DISPLAY_BAR_GLYPH_FIRST + lit - 1, bitmap );
+    }
+}
 
-        case DISPLAY_CONNECTION_GPIO_4BITS:
-            if ( initial8BitCommunicationIsCompleted == true) {
-                displayPinWrite( DISPLAY_PIN_EN, ON );
-                //HAL_Delay(1);
-                systick_delay_us(DISPLAY_DEL_01US);
-
-                displayPinWrite( DISPLAY_PIN_EN, OFF );
-                //HAL_Delay(1);
-                systick_delay_us(DISPLAY_DEL_01US);
-
-                displayPinWrite( DISPLAY_PIN_D7, dataBus & 0b00001000 );
-                displayPinWrite( DISPLAY_PIN_D6, dataBus & 0b00000100 );
-                displayPinWrite( DISPLAY_PIN_D5, dataBus & 0b00000010 );
-                displayPinWrite( DISPLAY_PIN_D4, dataBus & 0b00000001 );
+// Room for whole codes only: a code cut between its nibbles would leave
+// the 4-bit interface out of step for good, a full ring would stall the caller
+static bool displayBusRoom( uint32_t codes )
+{
+    uint32_t queued;
+
+    if ( display.connection == DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER ) {
+        return ( displayI2c.length + codes * DISPLAY_I2C_CODE_BYTES ) <= DISPLAY_I2C_BUFFER_SIZE;
+    }
+
+    if ( display.connection == DISPLAY_CONNECTION_GPIO_4BITS ) {
+        codes *= DISPLAY_RING_CODE_WORDS;
+    }
+
+    // One slot always stays free, head == tail means empty
+    queued = ( displayEngine.head - displayEngine.tail ) & DISPLAY_RING_MASK;
+    return ( queued + codes ) < DISPLAY_RING_SIZE;
+}
+
+static void displayBusWordPut( uint16_t busWord )
+{
+    uint32_t next = ( displayEngine.head + 1 ) & DISPLAY_RING_MASK;
+
+    // Same 4-bit words, sent as expander bytes instead of clocked out by TIM4
+    if ( display.connection == DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER ) {
+        displayI2cWordPut( busWord );
+        return;
+    }
+
+    // Ring full: wait for the ISR to make room. Only the short init and
+    // control writes can get here, displayFlush() checks displayBusRoom()
+    while ( next == displayEngine.tail ) {
+    }
+
+    displayEngine.ring[displayEngine.head] = busWord;
+    displayEngine.head = next;
+
+    /* Protect shared resource */
+    __asm("CPSID i");	/* disable interrupts */
+    if ( !displayEngine.busy ) {
+        displayEngine.busy = true;
+        displayTimerStart( DISPLAY_DEL_01US );
+    }
+    __asm("CPSIE i");	/* enable interrupts */
+}
+
+static void displayBusWordWrite( uint16_t busWord )
+{
+    uint8_t data = busWord & DISPLAY_BUS_DATA_MASK;
+    uint8_t rs = ( busWord & DISPLAY_BUS_RS ) ? DISPLAY_RS_DATA : DISPLAY_RS_INSTRUCTION;
+    displayBusPort_t *busPort;
+    uint8_t i;
+
+    // RW is tied low: always a write
+    for ( i = 0; i < displayBusPortQty; i++ ) {
+        busPort = &displayBusPorts[i];
+        busPort->port->BSRR = busPort->nibbleHigh[data >> 4] |
+                              busPort->nibbleLow[data & 0x0F] |
+                              busPort->rs[rs];
+    }
+
+    // Reading back waits for the stores to land: RS/data setup before EN
+    (void)displayBusPorts[displayBusPortQty - 1].port->ODR;
+    DISPLAY_EN_PORT->BSRR = DISPLAY_EN_PIN;
+}
+
+static void displayTimerInit( void )
+{
+    uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+
+    // APB1 timers run at twice PCLK1 when the APB1 prescaler is not 1
+    if ( ( RCC->CFGR & RCC_CFGR_PPRE1 ) != RCC_CFGR_PPRE1_DIV1 ) {
+        timerClock *= 2;
+    }
+
+    __HAL_RCC_TIM4_CLK_ENABLE();
+
+    DISPLAY_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    DISPLAY_TIM->PSC = ( timerClock / DISPLAY_TIM_TICK_HZ ) - 1;
+    DISPLAY_TIM->EGR = TIM_EGR_UG;
+    DISPLAY_TIM->SR = 0;
+    DISPLAY_TIM->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority( DISPLAY_TIM_IRQn, DISPLAY_TIM_IRQ_PRIORITY, 0 );
+    HAL_NVIC_EnableIRQ( DISPLAY_TIM_IRQn );
+}
+
+static void displayTimerStart( uint32_t delay_us )
+{
+    // One extra tick keeps ARR non-zero and the delay on the safe side
+    DISPLAY_TIM->ARR = delay_us;
+    DISPLAY_TIM->CNT = 0;
+    DISPLAY_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+static void displayPinOutputInit( const displayPin_t *pin )
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    HAL_GPIO_WritePin( pin->port, pin->pin, GPIO_PIN_RESET );
+
+    GPIO_InitStruct.Pin = pin->pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init( pin->port, &GPIO_InitStruct );
+}
+
+#if ( DISPLAY_USE_BUSY_FLAG == 1 )
+static void displayDataBusDirection( bool input )
+{
+    displayBusPort_t *busPort;
+    uint8_t i;
+
+    for ( i = 0; i < displayBusPortQty; i++ ) {
+        busPort = &displayBusPorts[i];
+        if ( input ) {
+            // ODR high selects the pull-up
+            busPort->port->BSRR = busPort->dataPins;
+            busPort->port->CRL = ( busPort->port->CRL & ~busPort->crMask[0] ) | busPort->crInput[0];
+            busPort->port->CRH = ( busPort->port->CRH & ~busPort->crMask[1] ) | busPort->crInput[1];
+        } else {
+            busPort->port->CRL = ( busPort->port->CRL & ~busPort->crMask[0] ) | busPort->crOutput[0];
+            busPort->port->CRH = ( busPort->port->CRH & ~busPort->crMask[1] ) | busPort->crOutput[1];
+        }
+    }
+}
+
+// Instruction read with the data pins as pulled-up inputs, RW must be wired
+static bool displayBusyFlagRead( void )
+{
+    bool busyFlag;
+
+    displayDataBusDirection( true );
+    DISPLAY_RS_PORT->BSRR = (uint32_t)DISPLAY_RS_PIN << 16;
+    DISPLAY_RW_PORT->BSRR = DISPLAY_RW_PIN;
+    displayDelayNs( DISPLAY_TAS_NS );
+
+    DISPLAY_EN_PORT->BSRR = DISPLAY_EN_PIN;
+    displayDelayNs( DISPLAY_TPW_NS );
+    busyFlag = ( DISPLAY_D7_PORT->IDR & DISPLAY_D7_PIN ) != 0;
+    DISPLAY_EN_PORT->BSRR = (uint32_t)DISPLAY_EN_PIN << 16;
+
+    // In 4-bit mode the address counter low nibble follows, clock it out
+    if ( display.connection == DISPLAY_CONNECTION_GPIO_4BITS ) {
+        displayDelayNs( DISPLAY_TPW_NS );
+        DISPLAY_EN_PORT->BSRR = DISPLAY_EN_PIN;
+        displayDelayNs( DISPLAY_TPW_NS );
+        DISPLAY_EN_PORT->BSRR = (uint32_t)DISPLAY_EN_PIN << 16;
+    }
+
+    DISPLAY_RW_PORT->BSRR = (uint32_t)DISPLAY_RW_PIN << 16;
+    displayDataBusDirection( false );
+
+    return busyFlag;
+}
+
+static void displayDelayNs( uint32_t delay_ns )
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = ( delay_ns * ( SystemCoreClock / 1000000ul ) + 999 ) / 1000;
+
+    while ( dwt_elapsed32( start ) < cycles ) {
+    }
+}
+#endif
+
+static displayBusPort_t *displayBusPortGet( GPIO_TypeDef *port )
+{
+    uint8_t i;
+
+    for ( i = 0; i < displayBusPortQty; i++ ) {
+        if ( displayBusPorts[i].port == port ) {
+            return &displayBusPorts[i];
+        }
+    }
+
+    displayBusPorts[displayBusPortQty].port = port;
+    return &displayBusPorts[displayBusPortQty++];
+}
+
+static void displayBusTableBuild( void )
+{
+    displayBusPort_t *busPort;
+    uint32_t pin;
+    uint8_t bit, value;
+    uint8_t firstBit;
+    uint32_t position, cr, shift;
+
+    memset( displayBusPorts, 0, sizeof(displayBusPorts) );
+    displayBusPortQty = 0;
+
+    // RS first, so its port is in the table even if no data pin shares it
+    busPort = displayBusPortGet( DISPLAY_RS_PORT );
+    busPort->rs[DISPLAY_RS_INSTRUCTION] = (uint32_t)DISPLAY_RS_PIN << 16;
+    busPort->rs[DISPLAY_RS_DATA] = DISPLAY_RS_PIN;
+
+    firstBit = ( display.connection == DISPLAY_CONNECTION_GPIO_8BITS ) ? 0 : 4;
+
+    for ( bit = firstBit; bit < 8; bit++ ) {
+        busPort = displayBusPortGet( displayDataPins[bit].port );
+        pin = displayDataPins[bit].pin;
+
+        // 4-bit mode/config field of the pin in CRL (pins 0..7) or CRH
+        position = 31 - __CLZ( pin );
+        cr = position / 8;
+        shift = ( position % 8 ) * 4;
+        busPort->dataPins |= pin;
+        busPort->crMask[cr] |= 0xFul << shift;
+        busPort->crInput[cr] |= GPIO_CRL_CNF0_1 << shift;
+        busPort->crOutput[cr] |= ( cr ? busPort->port->CRH : busPort->port->CRL ) & ( 0xFul << shift );
+
+        for ( value = 0; value < 16; value++ ) {
+            uint32_t image = ( value & ( 1 << ( bit & 0x03 ) ) ) ? pin : pin << 16;
+
+            if ( bit < 4 ) {
+                busPort->nibbleLow[value] |= image;
+            } else {
+                busPort->nibbleHigh[value] |= image;
             }
-        break;
+        }
+    }
+}
+
+static void displayI2cInit( void )
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+    displayI2c.length = 0;
+    displayI2c.busy = false;
+    displayI2c.dmaDone = false;
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    __HAL_RCC_I2C1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_AFIO_REMAP_I2C1_ENABLE();
+
+    GPIO_InitStruct.Pin = DISPLAY_I2C_SCL_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init( DISPLAY_I2C_SCL_PORT, &GPIO_InitStruct );
+    GPIO_InitStruct.Pin = DISPLAY_I2C_SDA_PIN;
+    HAL_GPIO_Init( DISPLAY_I2C_SDA_PORT, &GPIO_InitStruct );
 
+    // Standard mode: SCL high and low times of CCR PCLK1 periods each
+    DISPLAY_I2C->CR1 = I2C_CR1_SWRST;
+    DISPLAY_I2C->CR1 = 0;
+    DISPLAY_I2C->CR2 = pclk1 / 1000000ul;
+    DISPLAY_I2C->CCR = pclk1 / ( 2 * DISPLAY_I2C_CLOCK_HZ );
+    DISPLAY_I2C->TRISE = pclk1 / 1000000ul + 1;
+    DISPLAY_I2C->CR1 = I2C_CR1_PE;
+
+    DISPLAY_I2C_DMA->CCR = 0;
+    DISPLAY_I2C_DMA->CPAR = (uint32_t)&DISPLAY_I2C->DR;
+    DISPLAY_I2C_DMA->CMAR = (uint32_t)displayI2c.buffer;
+
+    HAL_NVIC_SetPriority( DISPLAY_I2C_EV_IRQn, DISPLAY_I2C_IRQ_PRIORITY, 0 );
+    HAL_NVIC_EnableIRQ( DISPLAY_I2C_EV_IRQn );
+    HAL_NVIC_SetPriority( DISPLAY_I2C_ER_IRQn, DISPLAY_I2C_IRQ_PRIORITY, 0 );
+    HAL_NVIC_EnableIRQ( DISPLAY_I2C_ER_IRQn );
+    HAL_NVIC_SetPriority( DISPLAY_I2C_DMA_IRQn, DISPLAY_I2C_IRQ_PRIORITY, 0 );
+    HAL_NVIC_EnableIRQ( DISPLAY_I2C_DMA_IRQn );
+}
+
+// A 4-bit bus word becomes: data and RS set up, EN high, EN low, then
+// padding bytes for delays longer than one byte time
+static void displayI2cWordPut( uint16_t busWord )
+{
+    uint8_t byte = ( busWord & 0xF0 ) | DISPLAY_PCF8574_BL;
+    displayDelay_t delay = (displayDelay_t)
+        ( ( busWord & DISPLAY_BUS_DELAY_MASK ) >> DISPLAY_BUS_DELAY_POS );
+    uint32_t padding = displayDelayUs[delay] / DISPLAY_I2C_BYTE_US;
+    uint8_t *out;
+
+    if ( busWord & DISPLAY_BUS_RS ) {
+        byte |= DISPLAY_PCF8574_RS;
+    }
+
+    if ( displayI2c.length + 3 + padding > DISPLAY_I2C_BUFFER_SIZE ) {
+        displayI2c.overflowCnt++;
+        return;
     }
-    displayPinWrite( DISPLAY_PIN_EN, ON );
-    //HAL_Delay(1);
-    systick_delay_us(DISPLAY_DEL_01US);
 
-    displayPinWrite( DISPLAY_PIN_EN, OFF );
-    //HAL_Delay(1);
-    systick_delay_us(DISPLAY_DEL_01US);
+    out = &displayI2c.buffer[displayI2c.length];
+    *out++ = byte;
+    *out++ = byte | DISPLAY_PCF8574_EN;
+    *out++ = byte;
+    memset( out, byte, padding );
+    displayI2c.length += 3 + padding;
+}
+
+static void displayI2cTransferStart( void )
+{
+    if ( ( display.connection != DISPLAY_CONNECTION_I2C_PCF8574_IO_EXPANDER ) ||
+         ( displayI2c.length == 0 ) ) {
+        return;
+    }
+
+    displayI2c.busy = true;
+    displayI2c.dmaDone = false;
+
+    // Memory to peripheral, the I2C pulls a byte on each TXE
+    DISPLAY_I2C_DMA->CCR = 0;
+    DISPLAY_I2C_DMA->CNDTR = displayI2c.length;
+    DISPLAY_I2C_DMA->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    DISPLAY_I2C->CR2 |= I2C_CR2_DMAEN | I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+    DISPLAY_I2C->CR1 |= I2C_CR1_START;
+}
+
+static void displayI2cTransferEnd( void )
+{
+    DISPLAY_I2C->CR1 |= I2C_CR1_STOP;
+    DISPLAY_I2C->CR2 &= ~( I2C_CR2_DMAEN | I2C_CR2_ITEVTEN | I2C_CR2_ITERREN );
+    DISPLAY_I2C_DMA->CCR = 0;
+
+    displayI2c.length = 0;
+    displayI2c.busy = false;
 }
 
 /********************** end of file ******************************************/
@@ -48,18 +48,39 @@
 
 /********************** macros and definitions *******************************/
 
+#define LOGGER_RING_MASK_       (LOGGER_CONFIG_RING_SIZE - 1)
+
+#if (LOGGER_TRACE_HEADER_LEN + (4 * LOGGER_CONFIG_TRACE_MAXARGS)) > (LOGGER_CONFIG_MAXLEN - 1)
+#error "LOGGER_CONFIG_TRACE_MAXARGS does not fit in LOGGER_CONFIG_MAXLEN"
+#endif
+
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
 
+#if (1 == LOGGER_CONFIG_ENABLE) && (1 == LOGGER_CONFIG_USE_UART)
+extern UART_HandleTypeDef huart2;
+
+/* Writers reserve space under a short critical section and copy with
+ * interrupts enabled; the bytes become visible to the USART2 ISR only
+ * once the last outstanding writer has finished copying. */
+static uint8_t logger_ring_[LOGGER_CONFIG_RING_SIZE];
+static uint32_t logger_reserve_;            /* end of reserved bytes */
+static uint32_t logger_writers_;            /* reservations being copied */
+static volatile uint32_t logger_commit_;    /* end of bytes ready to send */
+static volatile uint32_t logger_tail_;      /* next byte to send (ISR) */
+static bool logger_irq_enabled_;
+#endif
+
 /********************** external data definition *****************************/
 
 #if 1 == LOGGER_CONFIG_ENABLE
 static char logger_msg_buffer_[LOGGER_CONFIG_MAXLEN];
 char* const logger_msg = logger_msg_buffer_;
 int logger_msg_len;
+uint32_t logger_dropped;
 #endif
 
 /********************** internal functions definition ************************/
@@ -72,6 +93,11 @@ void logger_log_print_(char* const msg)
 	printf(msg);
 	fflush(stdout);
 }
+#elif (1 == LOGGER_CONFIG_ENABLE) && (1 == LOGGER_CONFIG_USE_UART)
+void logger_log_print_(char* const msg)
+{
+	logger_log_write_(msg, strlen(msg));
+}
 #else
 void logger_log_print_(char* const msg)
 {
@@ -79,4 +105,109 @@ void logger_log_print_(char* const msg)
 }
 #endif
 
+#if (1 == LOGGER_CONFIG_ENABLE) && (1 == LOGGER_CONFIG_USE_UART)
+void logger_log_write_(const char* msg, int len)
+{
+	uint32_t start;
+	uint32_t index;
+
+	if (0 >= len)
+	{
+		return;
+	}
+	if ((LOGGER_CONFIG_MAXLEN - 1) < len)
+	{
+		len = LOGGER_CONFIG_MAXLEN - 1;
+	}
+
+	/* Reserve */
+	__asm("CPSID i");	/* disable interrupts */
+	if ((LOGGER_CONFIG_RING_SIZE - (logger_reserve_ - logger_tail_)) < (uint32_t)len)
+	{
+		logger_dropped++;
+		__asm("CPSIE i");	/* enable interrupts */
+		return;
+	}
+	start = logger_reserve_;
+	logger_reserve_ += len;
+	logger_writers_++;
+	__asm("CPSIE i");	/* enable interrupts */
+
+	/* Copy */
+	for (index = 0; index < (uint32_t)len; index++)
+	{
+		logger_ring_[(start + index) & LOGGER_RING_MASK_] = msg[index];
+	}
+
+	/* Commit & start draining */
+	__asm("CPSID i");	/* disable interrupts */
+	logger_writers_--;
+	if (0 == logger_writers_)
+	{
+		logger_commit_ = logger_reserve_;
+		if (!logger_irq_enabled_)
+		{
+			HAL_NVIC_SetPriority(USART2_IRQn, LOGGER_CONFIG_UART_IRQ_PRIORITY, 0);
+			HAL_NVIC_EnableIRQ(USART2_IRQn);
+			logger_irq_enabled_ = true;
+		}
+		huart2.Instance->CR1 |= USART_CR1_TXEIE;
+	}
+	__asm("CPSIE i");	/* enable interrupts */
+}
+
+void logger_trace_write_(uint32_t id, uint32_t nargs, const uint32_t* args)
+{
+	uint8_t record[LOGGER_TRACE_HEADER_LEN + (4 * LOGGER_CONFIG_TRACE_MAXARGS)];
+	uint32_t timestamp = DWT->CYCCNT;
+
+	if (LOGGER_CONFIG_TRACE_MAXARGS < nargs)
+	{
+		nargs = LOGGER_CONFIG_TRACE_MAXARGS;
+	}
+
+	record[0] = LOGGER_TRACE_SYNC;
+	record[1] = (uint8_t)nargs;
+	memcpy(&record[2], &id, sizeof(id));
+	memcpy(&record[6], &timestamp, sizeof(timestamp));
+	memcpy(&record[LOGGER_TRACE_HEADER_LEN], args, 4 * nargs);
+
+	/* One reservation per record, so records never interleave */
+	logger_log_write_((const char*)record, LOGGER_TRACE_HEADER_LEN + (4 * nargs));
+}
+
+void logger_uart_irq_handler(void)
+{
+	USART_TypeDef *uart = huart2.Instance;
+
+	if ((uart->SR & USART_SR_TXE) && (uart->CR1 & USART_CR1_TXEIE))
+	{
+		if (logger_tail_ != logger_commit_)
+		{
+			uart->DR = logger_ring_[logger_tail_ & LOGGER_RING_MASK_];
+			logger_tail_++;
+		}
+		else
+		{
+			uart->CR1 &= ~USART_CR1_TXEIE;
+		}
+	}
+}
+#else
+void logger_log_write_(const char* msg, int len)
+{
+    return;
+}
+
+void logger_uart_irq_handler(void)
+{
+    return;
+}
+
+void logger_trace_write_(uint32_t id, uint32_t nargs, const uint32_t* args)
+{
+    return;
+}
+#endif
+
 /********************** end of file ******************************************/
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023 Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : task_display.c
+ * @date   : Set 26, 2023
+ * @author : Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes */
+#include "main.h"
+
+/* Demo includes */
+#include "logger.h"
+#include "dwt.h"
+
+/* Application & Tasks includes */
+#include "board.h"
+#include "app.h"
+#include "task_display.h"
+#include "display.h"
+
+/********************** macros and definitions *******************************/
+#define G_TASK_DIS_CNT_INI			0ul
+#define G_TASK_DIS_TICK_CNT_INI		0ul
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+const char *p_task_display 		= "Task Display (LCD Frame Commit)";
+const char *p_task_display_ 	= "Non-Blocking & Update By Time Code";
+
+/********************** external data declaration ****************************/
+uint32_t g_task_display_cnt;
+uint32_t g_task_display_commit_cnt;		/* Releases that sent cells to the LCD */
+volatile uint32_t g_task_display_tick_cnt;
+
+/********************** external functions definition ************************/
+void task_display_init(void *parameters)
+{
+	/* Print out: Task Initialized */
+	LOGGER_INFO(" ");
+	LOGGER_INFO("  %s is running - %s", GET_NAME(task_display_init), p_task_display);
+	LOGGER_INFO("  %s is a %s", GET_NAME(task_display), p_task_display_);
+
+	/* Init & Print out: Task execution counter */
+	g_task_display_cnt = G_TASK_DIS_CNT_INI;
+	g_task_display_commit_cnt = G_TASK_DIS_CNT_INI;
+	LOGGER_INFO("   %s = %lu", GET_NAME(g_task_display_cnt), g_task_display_cnt);
+
+	/* Init & Print out: LCD Display */
+	displayInit( DISPLAY_CONNECTION_GPIO_4BITS );
+}
+
+/* Runs once per frame period: whatever the other tasks drew since the last
+ * release goes out in a single commit, intermediate states are never sent */
+void task_display_update(void *parameters)
+{
+	bool b_time_update_required = false;
+
+	/* Protect shared resource */
+	__asm("CPSID i");	/* disable interrupts */
+	/* One release per call, app_update() applies the overrun policy */
+    if (G_TASK_DIS_TICK_CNT_INI < g_task_display_tick_cnt)
+    {
+		/* Update Tick Counter */
+    	g_task_display_tick_cnt--;
+    	b_time_update_required = true;
+    }
+    __asm("CPSIE i");	/* enable interrupts */
+
+    if (b_time_update_required)
+    {
+		/* Update Task Counter */
+		g_task_display_cnt++;
+
+		/* Bring the LCD up, then send it the cells changed since the last commit */
+		displayUpdate();
+		if ((true == displayReady()) && (true == displayDirty()))
+		{
+			g_task_display_commit_cnt++;
+			displayFlush();
+		}
+	}
+}
+
+/* True when the LCD is up with nothing left to send */
+bool task_display_idle(void)
+{
+	return ((true == displayReady()) &&
+			(false == displayDirty()) &&
+			(false == displayBusy()));
+}
+
+/********************** end of file ******************************************/
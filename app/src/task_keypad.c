@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2023 Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : task_keypad.c
+ * @date   : Set 26, 2023
+ * @author : Juan Manuel Cruz <jcruz@fi.uba.ar> <jcruz@frba.utn.edu.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes */
+#include "main.h"
+
+/* Demo includes */
+#include "logger.h"
+#include "dwt.h"
+
+/* Application & Tasks includes */
+#include "board.h"
+#include "app.h"
+#include "task_menu_attribute.h"
+#include "task_menu_interface.h"
+#include "task_keypad.h"
+#include "debounce.h"
+#include "task_keypad_attribute.h"
+
+/********************** macros and definitions *******************************/
+#define G_TASK_KEY_CNT_INI			0ul
+#define G_TASK_KEY_TICK_CNT_INI		0ul
+
+#define DEL_KEY_XX_MAX				5ul		/* Full scans, 4 ticks each */
+
+#if ((1ul << KEYPAD_COUNT_BITS) <= DEL_KEY_XX_MAX)
+#error "DEL_KEY_XX_MAX must fit in KEYPAD_COUNT_BITS"
+#endif
+
+#define KEYPAD_COLUMN_MASK			((1ul << KEYPAD_COLUMNS) - 1)
+#define KEYPAD_KEY_MASK				((1ul << KEYPAD_KEY_QTY) - 1)
+
+/********************** internal data declaration ****************************/
+/* 	1 2 3 A
+ * 	4 5 6 B
+ * 	7 8 9 C
+ * 	* 0 # D
+ */
+const task_keypad_cfg_t task_keypad_cfg = {
+	KEYPAD_ROW_PORT,	{KEYPAD_ROW_0_PIN, KEYPAD_ROW_1_PIN, KEYPAD_ROW_2_PIN, KEYPAD_ROW_3_PIN},
+	KEYPAD_COLUMN_PORT,	KEYPAD_COLUMN_SHIFT,
+	DEL_KEY_XX_MAX,
+	{EV_MEN_KEY_1,			EV_MEN_KEY_2,	EV_MEN_KEY_3,		EV_MEN_ENT_ACTIVE,
+	 EV_MEN_KEY_4,			EV_MEN_KEY_5,	EV_MEN_KEY_6,		EV_MEN_NEX_ACTIVE,
+	 EV_MEN_KEY_7,			EV_MEN_KEY_8,	EV_MEN_KEY_9,		EV_MEN_ESC_ACTIVE,
+	 EV_MEN_ENT_ESC_CHORD,	EV_MEN_KEY_0,	EV_MEN_ENT_ACTIVE,	EV_MEN_ESC_LONG}
+};
+
+task_keypad_dta_t task_keypad_dta;
+
+/* Row drive images: the driven row low, the other rows released */
+uint32_t task_keypad_row_bsrr[KEYPAD_ROWS];
+
+/********************** internal functions declaration ***********************/
+void task_keypad_scan(void);
+void task_keypad_debounce(uint16_t scan);
+
+/********************** internal data definition *****************************/
+const char *p_task_keypad 		= "Task Keypad (Matrix Scanner)";
+const char *p_task_keypad_ 		= "Non-Blocking & Update By Time Code";
+
+/********************** external data declaration ****************************/
+uint32_t g_task_keypad_cnt;
+volatile uint32_t g_task_keypad_tick_cnt;
+
+/********************** external functions definition ************************/
+void task_keypad_init(void *parameters)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	const task_keypad_cfg_t *p_task_keypad_cfg = &task_keypad_cfg;
+	uint32_t rows = 0;
+	uint32_t row;
+
+	/* Print out: Task Initialized */
+	LOGGER_INFO(" ");
+	LOGGER_INFO("  %s is running - %s", GET_NAME(task_keypad_init), p_task_keypad);
+	LOGGER_INFO("  %s is a %s", GET_NAME(task_keypad), p_task_keypad_);
+
+	/* Init & Print out: Task execution counter */
+	g_task_keypad_cnt = G_TASK_KEY_CNT_INI;
+	LOGGER_INFO("   %s = %lu", GET_NAME(g_task_keypad_cnt), g_task_keypad_cnt);
+
+	for (row = 0; KEYPAD_ROWS > row; row++)
+	{
+		rows |= p_task_keypad_cfg->row_pin[row];
+	}
+	for (row = 0; KEYPAD_ROWS > row; row++)
+	{
+		task_keypad_row_bsrr[row] = (rows & ~p_task_keypad_cfg->row_pin[row]) |
+									((uint32_t)p_task_keypad_cfg->row_pin[row] << 16);
+	}
+
+	/* Rows open-drain, so two keys on one column never short two rows */
+	p_task_keypad_cfg->row_port->BSRR = rows;
+	GPIO_InitStruct.Pin = rows;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(p_task_keypad_cfg->row_port, &GPIO_InitStruct);
+
+	GPIO_InitStruct.Pin = KEYPAD_COLUMN_MASK << p_task_keypad_cfg->column_shift;
+	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(p_task_keypad_cfg->column_port, &GPIO_InitStruct);
+
+	/* Init & Print out: all keys released, row 0 driven */
+	memset(&task_keypad_dta, 0, sizeof(task_keypad_dta));
+	debounce_tick_max_set(task_keypad_dta.tick_max, KEYPAD_COUNT_BITS,
+						  (uint16_t)KEYPAD_KEY_MASK, p_task_keypad_cfg->tick_max);
+	p_task_keypad_cfg->row_port->BSRR = task_keypad_row_bsrr[0];
+
+	LOGGER_INFO(" ");
+	LOGGER_INFO("   %s = %lu   %s = 0x%04lx",
+				GET_NAME(row), task_keypad_dta.row,
+				GET_NAME(state), (uint32_t)task_keypad_dta.state);
+}
+
+void task_keypad_update(void *parameters)
+{
+	bool b_time_update_required = false;
+
+	/* Protect shared resource */
+	__asm("CPSID i");	/* disable interrupts */
+	/* One release per call, app_update() applies the overrun policy */
+    if (G_TASK_KEY_TICK_CNT_INI < g_task_keypad_tick_cnt)
+    {
+		/* Update Tick Counter */
+    	g_task_keypad_tick_cnt--;
+    	b_time_update_required = true;
+    }
+    __asm("CPSIE i");	/* enable interrupts */
+
+    if (b_time_update_required)
+    {
+		/* Update Task Counter */
+		g_task_keypad_cnt++;
+
+		/* Run Task Keypad Scanner */
+		task_keypad_scan();
+	}
+}
+
+/* True when every key rests released: no debounce counter is running */
+bool task_keypad_idle(void)
+{
+	return ((0 == task_keypad_dta.state) &&
+			(false == debounce_counting(task_keypad_dta.count, KEYPAD_COUNT_BITS)));
+}
+
+/********************** internal functions definition ************************/
+/* One row per release: read the row driven since the last one, drive the next */
+void task_keypad_scan(void)
+{
+	const task_keypad_cfg_t *p_task_keypad_cfg = &task_keypad_cfg;
+	task_keypad_dta_t *p_task_keypad_dta = &task_keypad_dta;
+	uint32_t columns;
+
+	/* Columns are pulled up, a pressed key pulls its column to the driven row */
+	columns = (~p_task_keypad_cfg->column_port->IDR >> p_task_keypad_cfg->column_shift) & KEYPAD_COLUMN_MASK;
+	p_task_keypad_dta->scan |= (uint16_t)(columns << (p_task_keypad_dta->row * KEYPAD_COLUMNS));
+
+	p_task_keypad_dta->row++;
+	if (KEYPAD_ROWS <= p_task_keypad_dta->row)
+	{
+		p_task_keypad_dta->row = 0;
+		task_keypad_debounce(p_task_keypad_dta->scan);
+		p_task_keypad_dta->scan = 0;
+	}
+
+	p_task_keypad_cfg->row_port->BSRR = task_keypad_row_bsrr[p_task_keypad_dta->row];
+}
+
+/* Vertical counter over the whole matrix, see task_keypad_attribute.h */
+void task_keypad_debounce(uint16_t scan)
+{
+	const task_keypad_cfg_t *p_task_keypad_cfg = &task_keypad_cfg;
+	task_keypad_dta_t *p_task_keypad_dta = &task_keypad_dta;
+	uint32_t key;
+	uint16_t match;
+	uint32_t pressed;
+
+	match = debounce_update(&p_task_keypad_dta->state, p_task_keypad_dta->count,
+							p_task_keypad_dta->tick_max, KEYPAD_COUNT_BITS, scan);
+	if (0 == match)
+	{
+		return;
+	}
+
+	/* Keys act on press, releases only rearm them */
+	pressed = match & p_task_keypad_dta->state;
+	while (0 != pressed)
+	{
+		key = __CLZ(__RBIT(pressed));
+		pressed &= pressed - 1;
+
+		put_event_task_menu(p_task_keypad_cfg->signal_down[key]);
+	}
+}
+
+/********************** end of file ******************************************/
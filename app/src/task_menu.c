@@ -60,9 +60,24 @@
 #define DEL_MEN_XX_MED				50ul
 #define DEL_MEN_XX_MAX				500ul
 
+#define MENU_LINE_LEN				20
+#define MENU_MAIN_MOTOR_QTY			2	/* Status lines on the main screen */
+
+/* Slots of the status line template, "Motor 1: OFF,0,R [bar]" */
+#define MENU_STATUS_MOTOR_POS		6
+#define MENU_STATUS_POWER_POS		9
+#define MENU_STATUS_POWER_LEN		3
+#define MENU_STATUS_SPEED_POS		13
+#define MENU_STATUS_SPIN_POS		15
+#define MENU_STATUS_BAR_POS			17
+#define MENU_STATUS_BAR_WIDTH		(MENU_LINE_LEN - MENU_STATUS_BAR_POS)
+#define MENU_SPEED_MAX				9
+
+#define MENU_NEXT_MOTOR_POS			14	/* "Next -> Motor 2" */
+
 /********************** internal data declaration ****************************/
 task_menu_dta_t task_menu_dta =
-	{DEL_MEN_XX_MIN, ST_MEN_XX_MAIN, EV_MEN_ENT_IDLE, false, true};
+	{DEL_MEN_XX_MIN, ST_MEN_XX_MAIN, EV_MEN_ENT_IDLE, false, true, 0, ID_PAR_POWER, 0};
 
 #define MENU_DTA_QTY	(sizeof(task_menu_dta)/sizeof(task_menu_dta_t))
 
@@ -78,10 +93,75 @@ motor_dta_t	motor_dta_list[] = {
 /********************** internal functions declaration ***********************/
 void task_menu_statechart(void);
 
+void task_menu_main_enter(task_menu_dta_t *p_task_menu_dta);
+void task_menu_motor_enter(task_menu_dta_t *p_task_menu_dta);
+void task_menu_motor_next(task_menu_dta_t *p_task_menu_dta);
+void task_menu_param_enter(task_menu_dta_t *p_task_menu_dta);
+void task_menu_param_next(task_menu_dta_t *p_task_menu_dta);
+void task_menu_option_enter(task_menu_dta_t *p_task_menu_dta);
+void task_menu_option_next(task_menu_dta_t *p_task_menu_dta);
+void task_menu_all_stop(task_menu_dta_t *p_task_menu_dta);
+void task_menu_motor_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit);
+void task_menu_param_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit);
+void task_menu_option_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit);
+
+void task_menu_main_render(const task_menu_dta_t *p_task_menu_dta);
+void task_menu_motor_render(const task_menu_dta_t *p_task_menu_dta);
+void task_menu_param_render(const task_menu_dta_t *p_task_menu_dta);
+void task_menu_option_render(const task_menu_dta_t *p_task_menu_dta);
+
+void task_menu_power_set(motor_dta_t *p_motor_dta, uint32_t option);
+void task_menu_spin_set(motor_dta_t *p_motor_dta, uint32_t option);
+void task_menu_speed_set(motor_dta_t *p_motor_dta, uint32_t option);
+
+uint32_t task_menu_text_put(char *p_line, uint32_t pos, const char *p_text);
+void task_menu_line_write(uint8_t row, char *p_line, uint32_t len);
+void task_menu_text_write(uint8_t row, const char *p_text);
+void task_menu_status_write(uint8_t row, uint32_t motor);
+
 /********************** internal data definition *****************************/
 const char *p_task_menu 		= "Task Menu (Interactive Menu)";
 const char *p_task_menu_ 		= "Non-Blocking & Update By Time Code";
 
+/* Menu tree, indexed by task_menu_st_t */
+const task_menu_node_t task_menu_node_list[] = {
+	/* parent			enter						next					digit					render */
+	{ST_MEN_XX_MAIN,	task_menu_main_enter,		NULL,					NULL,					task_menu_main_render},
+	{ST_MEN_XX_MAIN,	task_menu_motor_enter,		task_menu_motor_next,	task_menu_motor_digit,	task_menu_motor_render},
+	{ST_MEN_XX_MOTOR,	task_menu_param_enter,		task_menu_param_next,	task_menu_param_digit,	task_menu_param_render},
+	{ST_MEN_XX_PARAM,	task_menu_option_enter,		task_menu_option_next,	task_menu_option_digit,	task_menu_option_render}
+};
+
+const char * const power_option_name[] = {"Turn ON", "Turn OFF"};
+const char * const spin_option_name[] = {"Left", "Right"};
+const char * const speed_option_name[] = {"Speed 0", "Speed 1", "Speed 2", "Speed 3", "Speed 4",
+										  "Speed 5", "Speed 6", "Speed 7", "Speed 8", "Speed 9"};
+
+#define OPTION_QTY(list)	(sizeof(list)/sizeof(list[0]))
+
+/* Motor parameters, indexed by task_menu_par_t */
+const task_menu_par_cfg_t task_menu_par_cfg_list[] = {
+	{"Power",	power_option_name,	OPTION_QTY(power_option_name),	task_menu_power_set},
+	{"Spin",	spin_option_name,	OPTION_QTY(spin_option_name),	task_menu_spin_set},
+	{"Speed",	speed_option_name,	OPTION_QTY(speed_option_name),	task_menu_speed_set}
+};
+
+const char menu_blank_line[MENU_LINE_LEN + 1] = "                    ";
+
+/* Fixed-field templates, patched in place from the lookups below */
+const char menu_status_template[] = "Motor 0: OFF,0,R ";
+const char menu_next_motor_template[] = "Next -> Motor 0";
+
+const char menu_digit[] = "0123456789";
+const char menu_power_field[][MENU_STATUS_POWER_LEN + 1] = {"OFF", " ON"};
+const char menu_spin_field[] = {'R', 'L'};
+
+/* Status line of each motor, kept between redraws */
+char menu_status_line[MOTOR_DTA_QTY][MENU_LINE_LEN + 1];
+
+/* Line being composed by a render function */
+char menu_line[MENU_LINE_LEN + 1];
+
 /********************** external data declaration ****************************/
 uint32_t g_task_menu_cnt;
 volatile uint32_t g_task_menu_tick_cnt;
@@ -124,12 +204,19 @@ void task_menu_init(void *parameters)
 	c_event = true;
 	p_task_menu_dta->flag_lcd = c_event;
 
+	p_task_menu_dta->motor = 0;
+	p_task_menu_dta->parameter = ID_PAR_POWER;
+	p_task_menu_dta->option = 0;
+
 	for (index = 0; MOTOR_DTA_QTY > index; index++)
 		{
 			motor_dta_list[index].power = false; //false = off
 			motor_dta_list[index].spin = true; // true = right
 			motor_dta_list[index].speed = 0; // 0 = 0 velocity
 
+			/* Only the power, speed and spin slots change from now on */
+			memcpy(menu_status_line[index], menu_status_template, sizeof(menu_status_template));
+			menu_status_line[index][MENU_STATUS_MOTOR_POS] = menu_digit[(index + 1) % 10];
 		}
 
 	LOGGER_INFO(" ");
@@ -137,9 +224,6 @@ void task_menu_init(void *parameters)
 				 GET_NAME(state), (uint32_t)state,
 				 GET_NAME(event), (uint32_t)event,
 				 GET_NAME(b_event), (b_event ? "true" : "false"));
-
-	/* Init & Print out: LCD Display */
-	displayInit( DISPLAY_CONNECTION_GPIO_4BITS );
 }
 
 void task_menu_update(void *parameters)
@@ -148,6 +232,7 @@ void task_menu_update(void *parameters)
 
 	/* Protect shared resource */
 	__asm("CPSID i");	/* disable interrupts */
+	/* One release per call, app_update() applies the overrun policy */
     if (G_TASK_MEN_TICK_CNT_INI < g_task_menu_tick_cnt)
     {
 		/* Update Tick Counter */
@@ -156,1538 +241,301 @@ void task_menu_update(void *parameters)
     }
     __asm("CPSIE i");	/* enable interrupts */
 
-    while (b_time_update_required)
+    if (b_time_update_required)
     {
 		/* Update Task Counter */
 		g_task_menu_cnt++;
 
 		/* Run Task Menu Statechart */
     	task_menu_statechart();
-
-    	/* Protect shared resource */
-		__asm("CPSID i");	/* disable interrupts */
-		if (G_TASK_MEN_TICK_CNT_INI < g_task_menu_tick_cnt)
-		{
-			/* Update Tick Counter */
-			g_task_menu_tick_cnt--;
-			b_time_update_required = true;
-		}
-		else
-		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts */
 	}
 }
 
 
+/* True when no event is queued and the last screen has been drawn */
+bool task_menu_idle(void)
+{
+	return ((false == any_event_task_menu()) &&
+			(false == task_menu_dta.flag_lcd));
+}
+
 void task_menu_statechart(void)
 {
 	task_menu_dta_t *p_task_menu_dta;
-
-	char menu_str_1[32];
-	char menu_str_2[32];
+	const task_menu_node_t *p_task_menu_node;
 
 	p_task_menu_dta = &task_menu_dta;
 
-	if (true == any_event_task_menu())
+	if ((ST_MEN_XX_QTY <= p_task_menu_dta->state) ||
+		(MOTOR_DTA_QTY <= p_task_menu_dta->motor) ||
+		(ID_PAR_QTY <= p_task_menu_dta->parameter))
 	{
-		p_task_menu_dta->flag = true;
-		p_task_menu_dta->flag_lcd = true;
-		p_task_menu_dta->event = get_event_task_menu();
+		p_task_menu_dta->tick  = DEL_MEN_XX_MIN;
+		p_task_menu_dta->state = ST_MEN_XX_MAIN;
+		p_task_menu_dta->event = EV_MEN_ENT_IDLE;
+		p_task_menu_dta->flag  = false;
+		p_task_menu_dta->flag_lcd  = true;
+		p_task_menu_dta->motor = 0;
+		p_task_menu_dta->parameter = ID_PAR_POWER;
+		p_task_menu_dta->option = 0;
 	}
 
-	switch (p_task_menu_dta->state)
+	/* Dispatch every queued event, only the screen they lead to is drawn */
+	while (true == any_event_task_menu())
 	{
-		case ST_MEN_XX_MAIN:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_1, sizeof(menu_str_1), "Motor 1: %s, %lu, %s", (motor_dta_list[0].power ? "ON" : "OFF"),
-						motor_dta_list[0].speed , (motor_dta_list[0].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_1);
-
-				snprintf(menu_str_2, sizeof(menu_str_2), "Motor 2: %s, %lu, %s", (motor_dta_list[1].power ? "ON" : "OFF"),
-						motor_dta_list[1].speed , (motor_dta_list[1].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 1);
-				displayStringWrite(menu_str_2);
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter/Next/Escape   ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("                    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-			break;
-
-		case ST_MEN_XX_MOTOR_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			else if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			else if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MAIN;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_1, sizeof(menu_str_1), "Motor 1: %s, %lu, %s", (motor_dta_list[0].power ? "ON" : "OFF"),
-						motor_dta_list[0].speed , (motor_dta_list[0].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_1);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Motor 2     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1_ON;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_1, sizeof(menu_str_1), "Motor 1: %s, %lu, %s", (motor_dta_list[0].power ? "ON" : "OFF"),
-						motor_dta_list[0].speed , (motor_dta_list[0].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_1);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Power |Next -> Spin ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1_L;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_1, sizeof(menu_str_1), "Motor 1: %s, %lu, %s", (motor_dta_list[0].power ? "ON" : "OFF"),
-						motor_dta_list[0].speed , (motor_dta_list[0].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_1);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Spin |Next -> Speed ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_0;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_1, sizeof(menu_str_1), "Motor 1: %s, %lu, %s", (motor_dta_list[0].power ? "ON" : "OFF"),
-						motor_dta_list[0].speed , (motor_dta_list[0].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_1);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Speed |Next -> Power");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_1_ON:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				motor_dta_list[0].power = true;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1_OFF;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Turn ON    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Turn OFF    ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_1_OFF:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				motor_dta_list[0].power = false;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1_ON;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Turn OFF   ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Turn ON     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_1_L:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1;
-				motor_dta_list[0].spin = false;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1_R;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Right      ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Left        ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_1_R:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1;
-				motor_dta_list[0].spin = true;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1_L;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Left       ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Right       ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_0:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 0;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 0    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 1     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 1    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 2     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_2:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_3;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 2    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 3     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_3:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 3;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_4;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 3    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 4     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_4:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 4;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_5;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 4    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 5     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_5:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 5;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_6;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 5    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 6     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_6:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 6;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_7;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 6    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 7     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_7:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 7;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_8;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 7    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 8     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_8:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 8;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_9;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 8    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 9     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_1_9:
+		p_task_menu_dta->flag = true;
+		p_task_menu_dta->flag_lcd = true;
+		p_task_menu_dta->event = get_event_task_menu();
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				motor_dta_list[0].speed = 9;
-				p_task_menu_dta->flag = false;
-			}
+		p_task_menu_node = &task_menu_node_list[p_task_menu_dta->state];
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1_0;
-				p_task_menu_dta->flag = false;
-			}
+		switch (p_task_menu_dta->event)
+		{
+			case EV_MEN_ENT_ACTIVE:
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 1: Speed 9    ");
+				if (NULL != p_task_menu_node->enter)
+					p_task_menu_node->enter(p_task_menu_dta);
 
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 0     ");
+				break;
 
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
+			case EV_MEN_NEX_ACTIVE:
+			case EV_MEN_NEX_REPEAT:
 
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
+				if (NULL != p_task_menu_node->next)
+					p_task_menu_node->next(p_task_menu_dta);
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+				break;
 
-			break;
+			case EV_MEN_ESC_ACTIVE:
 
-		case ST_MEN_XX_MOTOR_2:
+				p_task_menu_dta->state = p_task_menu_node->parent;
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				p_task_menu_dta->flag = false;
-			}
+				break;
 
-			else if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_1;
-				p_task_menu_dta->flag = false;
-			}
+			case EV_MEN_ESC_LONG:
 
-			else if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
 				p_task_menu_dta->state = ST_MEN_XX_MAIN;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_2, sizeof(menu_str_2), "Motor 2: %s, %lu, %s", (motor_dta_list[1].power ? "ON" : "OFF"),
-						motor_dta_list[1].speed , (motor_dta_list[1].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_2);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Motor 1     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_2:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2_ON;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_2, sizeof(menu_str_2), "Motor 2: %s, %lu, %s", (motor_dta_list[1].power ? "ON" : "OFF"),
-						motor_dta_list[1].speed , (motor_dta_list[1].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_2);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Power |Next -> Spin ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_2:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2_L;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_2, sizeof(menu_str_2), "Motor 2: %s, %lu, %s", (motor_dta_list[1].power ? "ON" : "OFF"),
-						motor_dta_list[1].speed , (motor_dta_list[1].spin ? "L" : "R"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_2);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Spin |Next -> Speed ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_0;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_MOTOR_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				snprintf(menu_str_2, sizeof(menu_str_2), "Motor 2: %s, %lu, %s", (motor_dta_list[1].power ? "ON" : "OFF"),
-						motor_dta_list[1].speed , (motor_dta_list[1].spin ? "R" : "L"));
-				displayCharPositionWrite(0, 0);
-				displayStringWrite(menu_str_2);
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Speed |Next -> Power");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to edit       ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_2_ON:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				motor_dta_list[1].power = true;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2_OFF;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Turn ON    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Turn OFF    ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_POWER_2_OFF:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				motor_dta_list[1].power = false;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2_ON;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_POWER_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Turn OFF   ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Turn ON     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_2_L:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2;
-				motor_dta_list[1].spin = false;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2_R;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Right      ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Left        ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPIN_2_R:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2;
-				motor_dta_list[1].spin = true;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2_L;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPIN_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Left       ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Right       ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_0:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 0;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 0    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 1     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_1:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 1;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 1    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 2     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_2:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_3;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 2    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 3     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+				break;
 
-			break;
+			case EV_MEN_ENT_ESC_CHORD:
 
-		case ST_MEN_XX_SPEED_2_3:
+				task_menu_all_stop(p_task_menu_dta);
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 3;
-				p_task_menu_dta->flag = false;
-			}
+				break;
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_4;
-				p_task_menu_dta->flag = false;
-			}
+			default:
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
+				if ((EV_MEN_KEY_0 <= p_task_menu_dta->event) && (EV_MEN_KEY_9 >= p_task_menu_dta->event) &&
+					(NULL != p_task_menu_node->digit))
+					p_task_menu_node->digit(p_task_menu_dta, p_task_menu_dta->event - EV_MEN_KEY_0);
 
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 3    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 4     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_4:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 4;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_5;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 4    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 5     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_5:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 5;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_6;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 5    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 6     ");
-
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
-
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
-
-				p_task_menu_dta->flag_lcd = false;
-			}
-
-			break;
-
-		case ST_MEN_XX_SPEED_2_6:
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 6;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_7;
-				p_task_menu_dta->flag = false;
-			}
-
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
-
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 6    ");
-
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 7     ");
+				break;
+		}
 
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
+		p_task_menu_dta->flag = false;
+	}
 
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
+	/* Render the screen of the node reached, task_display commits it */
+	if (true == p_task_menu_dta->flag_lcd)
+	{
+		task_menu_node_list[p_task_menu_dta->state].render(p_task_menu_dta);
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+		p_task_menu_dta->flag_lcd = false;
+	}
+}
 
-			break;
+/********************** internal functions definition ************************/
+void task_menu_main_enter(task_menu_dta_t *p_task_menu_dta)
+{
+	p_task_menu_dta->motor = 0;
+	p_task_menu_dta->state = ST_MEN_XX_MOTOR;
+}
 
-		case ST_MEN_XX_SPEED_2_7:
+void task_menu_motor_enter(task_menu_dta_t *p_task_menu_dta)
+{
+	p_task_menu_dta->parameter = ID_PAR_POWER;
+	p_task_menu_dta->state = ST_MEN_XX_PARAM;
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 7;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_motor_next(task_menu_dta_t *p_task_menu_dta)
+{
+	p_task_menu_dta->motor = (p_task_menu_dta->motor + 1) % MOTOR_DTA_QTY;
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_8;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_param_enter(task_menu_dta_t *p_task_menu_dta)
+{
+	p_task_menu_dta->option = 0;
+	p_task_menu_dta->state = ST_MEN_XX_OPTION;
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_param_next(task_menu_dta_t *p_task_menu_dta)
+{
+	p_task_menu_dta->parameter = (p_task_menu_dta->parameter + 1) % ID_PAR_QTY;
+}
 
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 7    ");
+void task_menu_option_enter(task_menu_dta_t *p_task_menu_dta)
+{
+	const task_menu_par_cfg_t *p_task_menu_par_cfg = &task_menu_par_cfg_list[p_task_menu_dta->parameter];
 
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 8     ");
+	p_task_menu_par_cfg->set(&motor_dta_list[p_task_menu_dta->motor], p_task_menu_dta->option);
+	p_task_menu_dta->state = ST_MEN_XX_PARAM;
+}
 
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
+void task_menu_option_next(task_menu_dta_t *p_task_menu_dta)
+{
+	const task_menu_par_cfg_t *p_task_menu_par_cfg = &task_menu_par_cfg_list[p_task_menu_dta->parameter];
 
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
+	p_task_menu_dta->option = (p_task_menu_dta->option + 1) % p_task_menu_par_cfg->option_qty;
+}
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+/* Digits pick an entry directly, 1-based as the screens number motors */
+void task_menu_motor_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit)
+{
+	if ((0 < digit) && (MOTOR_DTA_QTY >= digit))
+		p_task_menu_dta->motor = digit - 1;
+}
 
-			break;
+void task_menu_param_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit)
+{
+	if ((0 < digit) && (ID_PAR_QTY >= digit))
+		p_task_menu_dta->parameter = (task_menu_par_t)(digit - 1);
+}
 
-		case ST_MEN_XX_SPEED_2_8:
+/* Options count from 0, so "Speed n" is digit n; ENT still sets it */
+void task_menu_option_digit(task_menu_dta_t *p_task_menu_dta, uint32_t digit)
+{
+	if (task_menu_par_cfg_list[p_task_menu_dta->parameter].option_qty > digit)
+		p_task_menu_dta->option = digit;
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 8;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_all_stop(task_menu_dta_t *p_task_menu_dta)
+{
+	uint32_t motor;
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_9;
-				p_task_menu_dta->flag = false;
-			}
+	for (motor = 0; MOTOR_DTA_QTY > motor; motor++)
+	{
+		motor_dta_list[motor].power = false;
+	}
+	p_task_menu_dta->state = ST_MEN_XX_MAIN;
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_main_render(const task_menu_dta_t *p_task_menu_dta)
+{
+	uint32_t motor;
 
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 8    ");
+	for (motor = 0; MENU_MAIN_MOTOR_QTY > motor; motor++)
+	{
+		if (MOTOR_DTA_QTY > motor)
+			task_menu_status_write(motor, motor);
+		else
+			task_menu_text_write(motor, "");
+	}
 
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 9     ");
+	task_menu_text_write(2, "Enter/Next/Escape");
+	task_menu_text_write(3, "");
+}
 
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
+void task_menu_motor_render(const task_menu_dta_t *p_task_menu_dta)
+{
+	task_menu_status_write(0, p_task_menu_dta->motor);
 
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
+	memcpy(menu_line, menu_next_motor_template, sizeof(menu_next_motor_template));
+	menu_line[MENU_NEXT_MOTOR_POS] = menu_digit[((p_task_menu_dta->motor + 1) % MOTOR_DTA_QTY + 1) % 10];
+	task_menu_line_write(1, menu_line, sizeof(menu_next_motor_template) - 1);
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+	task_menu_text_write(2, "Enter to edit");
+	task_menu_text_write(3, "Escape to return");
+}
 
-			break;
+void task_menu_param_render(const task_menu_dta_t *p_task_menu_dta)
+{
+	uint32_t pos;
 
-		case ST_MEN_XX_SPEED_2_9:
+	task_menu_status_write(0, p_task_menu_dta->motor);
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				motor_dta_list[1].speed = 9;
-				p_task_menu_dta->flag = false;
-			}
+	pos = task_menu_text_put(menu_line, 0, task_menu_par_cfg_list[p_task_menu_dta->parameter].name);
+	pos = task_menu_text_put(menu_line, pos, " |Next -> ");
+	pos = task_menu_text_put(menu_line, pos,
+							 task_menu_par_cfg_list[(p_task_menu_dta->parameter + 1) % ID_PAR_QTY].name);
+	task_menu_line_write(1, menu_line, pos);
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2_0;
-				p_task_menu_dta->flag = false;
-			}
+	task_menu_text_write(2, "Enter to edit");
+	task_menu_text_write(3, "Escape to return");
+}
 
-			if ((true == p_task_menu_dta->flag) && (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event))
-			{
-				p_task_menu_dta->state = ST_MEN_XX_SPEED_2;
-				p_task_menu_dta->flag = false;
-			}
+void task_menu_option_render(const task_menu_dta_t *p_task_menu_dta)
+{
+	const task_menu_par_cfg_t *p_task_menu_par_cfg = &task_menu_par_cfg_list[p_task_menu_dta->parameter];
+	uint32_t option = p_task_menu_dta->option;
+	uint32_t pos;
+
+	/* "Motor N: " is the head of the status line */
+	memcpy(menu_line, menu_status_line[p_task_menu_dta->motor], MENU_STATUS_POWER_POS);
+	pos = task_menu_text_put(menu_line, MENU_STATUS_POWER_POS, p_task_menu_par_cfg->option_name[option]);
+	task_menu_line_write(0, menu_line, pos);
+
+	pos = task_menu_text_put(menu_line, 0, "Next -> ");
+	pos = task_menu_text_put(menu_line, pos,
+							 p_task_menu_par_cfg->option_name[(option + 1) % p_task_menu_par_cfg->option_qty]);
+	task_menu_line_write(1, menu_line, pos);
+
+	task_menu_text_write(2, "Enter to set");
+	task_menu_text_write(3, "Escape to return");
+}
 
-			if (true == p_task_menu_dta->flag_lcd)
-			{
-				displayCharPositionWrite(0, 0);
-				displayStringWrite("Motor 2: Speed 9    ");
+void task_menu_power_set(motor_dta_t *p_motor_dta, uint32_t option)
+{
+	p_motor_dta->power = (0 == option);		// "Turn ON" is listed first
+}
 
-				displayCharPositionWrite(0, 1);
-				displayStringWrite("Next -> Speed 0     ");
+void task_menu_spin_set(motor_dta_t *p_motor_dta, uint32_t option)
+{
+	p_motor_dta->spin = (0 == option);		// "Left" is listed first, shown as 'L'
+}
 
-				displayCharPositionWrite(0, 2);
-				displayStringWrite("Enter to set        ");
+void task_menu_speed_set(motor_dta_t *p_motor_dta, uint32_t option)
+{
+	p_motor_dta->speed = option;
+}
 
-				displayCharPositionWrite(0, 3);
-				displayStringWrite("Escape to return    ");
+/* Copies p_text at pos, clipped to the line, returns the position after it */
+uint32_t task_menu_text_put(char *p_line, uint32_t pos, const char *p_text)
+{
+	while (('\0' != *p_text) && (MENU_LINE_LEN > pos))
+	{
+		p_line[pos++] = *p_text++;
+	}
+	return pos;
+}
 
-				p_task_menu_dta->flag_lcd = false;
-			}
+void task_menu_line_write(uint8_t row, char *p_line, uint32_t len)
+{
+	/* Pad with blanks so nothing of the previous screen is left over */
+	memcpy(&p_line[len], menu_blank_line, MENU_LINE_LEN - len);
+	p_line[MENU_LINE_LEN] = '\0';
 
-			break;
+	displayRegionWrite(0, row, p_line, MENU_LINE_LEN);
+}
 
-		default:
+void task_menu_text_write(uint8_t row, const char *p_text)
+{
+	task_menu_line_write(row, menu_line, task_menu_text_put(menu_line, 0, p_text));
+}
 
-			p_task_menu_dta->tick  = DEL_MEN_XX_MIN;
-			p_task_menu_dta->state = ST_MEN_XX_MAIN;
-			p_task_menu_dta->event = EV_MEN_ENT_IDLE;
-			p_task_menu_dta->flag  = false;
-			p_task_menu_dta->flag_lcd  = true;
+void task_menu_status_write(uint8_t row, uint32_t motor)
+{
+	char *p_line = menu_status_line[motor];
+	const motor_dta_t *p_motor_dta = &motor_dta_list[motor];
 
-			break;
-	}
+	memcpy(&p_line[MENU_STATUS_POWER_POS], menu_power_field[p_motor_dta->power], MENU_STATUS_POWER_LEN);
+	p_line[MENU_STATUS_SPEED_POS] = menu_digit[p_motor_dta->speed % 10];
+	p_line[MENU_STATUS_SPIN_POS] = menu_spin_field[p_motor_dta->spin];
 
+	/* The speed bar fills the rest of the line */
+	displayRegionWrite(0, row, p_line, MENU_STATUS_BAR_POS);
+	displayBarWrite(MENU_STATUS_BAR_POS, row, MENU_STATUS_BAR_WIDTH,
+					p_motor_dta->speed, MENU_SPEED_MAX);
 }
 
 /********************** end of file ******************************************/
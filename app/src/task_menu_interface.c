@@ -51,19 +51,28 @@
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
-#define MAX_EVENTS		(16)
+#define MAX_EVENTS		(16)	/* Must be a power of two */
+#define MASK_EVENTS		(MAX_EVENTS - 1)
+
+#if (0 != (MAX_EVENTS & MASK_EVENTS))
+#error "MAX_EVENTS must be a power of two"
+#endif
 
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
+/* Single-producer / single-consumer ring: head is only written by the
+ * producer (put), tail only by the consumer (get). Both run freely and
+ * are masked on access, so head - tail is the number of pending events. */
 struct
 {
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_menu_ev_t	queue[MAX_EVENTS];
+	volatile uint32_t	head;
+	volatile uint32_t	tail;
+	task_menu_ev_t		queue[MAX_EVENTS];
+	uint32_t			overflow;		/* Events dropped on a full queue */
+	uint32_t			high_watermark;	/* Max events pending at once */
 } queue_task_a;
 
 /********************** external data declaration ****************************/
@@ -75,7 +84,8 @@ void init_queue_event_task_menu(void)
 
 	queue_task_a.head = 0;
 	queue_task_a.tail = 0;
-	queue_task_a.count = 0;
+	queue_task_a.overflow = 0;
+	queue_task_a.high_watermark = 0;
 
 	for (i = 0; i < MAX_EVENTS; i++)
 		queue_task_a.queue[i] = EVENT_UNDEFINED;
@@ -83,23 +93,42 @@ void init_queue_event_task_menu(void)
 
 void put_event_task_menu(task_menu_ev_t event)
 {
-	queue_task_a.count++;
-	queue_task_a.queue[queue_task_a.head++] = event;
+	uint32_t head = queue_task_a.head;
+	uint32_t pending = head - queue_task_a.tail;
+
+	/* Full: keep the pending events, drop the new one */
+	if (MAX_EVENTS <= pending)
+	{
+		queue_task_a.overflow++;
+		return;
+	}
+
+	queue_task_a.queue[head & MASK_EVENTS] = event;
 
-	if (MAX_EVENTS == queue_task_a.head)
-		queue_task_a.head = 0;
+	/* The slot must be visible before the consumer sees the new head */
+	__DMB();
+	queue_task_a.head = head + 1;
+
+	if (queue_task_a.high_watermark < (pending + 1))
+		queue_task_a.high_watermark = pending + 1;
 }
 
 task_menu_ev_t get_event_task_menu(void)
 {
 	task_menu_ev_t event;
+	uint32_t tail = queue_task_a.tail;
+
+	if (queue_task_a.head == tail)
+		return (task_menu_ev_t)EVENT_UNDEFINED;
 
-	queue_task_a.count--;
-	event = queue_task_a.queue[queue_task_a.tail];
-	queue_task_a.queue[queue_task_a.tail++] = EVENT_UNDEFINED;
+	/* Read the slot only after the head that published it */
+	__DMB();
+	event = queue_task_a.queue[tail & MASK_EVENTS];
+	queue_task_a.queue[tail & MASK_EVENTS] = EVENT_UNDEFINED;
 
-	if (MAX_EVENTS == queue_task_a.tail)
-		queue_task_a.tail = 0;
+	/* The slot must be released before the producer sees the new tail */
+	__DMB();
+	queue_task_a.tail = tail + 1;
 
 	return event;
 }
@@ -109,4 +138,14 @@ bool any_event_task_menu(void)
   return (queue_task_a.head != queue_task_a.tail);
 }
 
+uint32_t get_overflow_event_task_menu(void)
+{
+	return queue_task_a.overflow;
+}
+
+uint32_t get_high_watermark_event_task_menu(void)
+{
+	return queue_task_a.high_watermark;
+}
+
 /********************** end of file ******************************************/
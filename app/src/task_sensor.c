@@ -42,6 +42,7 @@
 /* Demo includes */
 #include "logger.h"
 #include "dwt.h"
+#include "debounce.h"
 
 /* Application & Tasks includes */
 #include "board.h"
@@ -58,28 +59,94 @@
 #define DEL_BTN_XX_MED				25ul
 #define DEL_BTN_XX_MAX				50ul
 
+#if ((DEL_BTN_XX_MAX <= DEL_BTN_XX_MIN) || ((1ul << SENSOR_COUNT_BITS) <= DEL_BTN_XX_MAX))
+#error "DEL_BTN_XX_MAX must fit in SENSOR_COUNT_BITS"
+#endif
+
+#define DEL_BTN_XX_LONG				800ul	/* Held this long: long press */
+#define DEL_BTN_XX_REPEAT_MAX		250ul	/* Then repeats, first period */
+#define DEL_BTN_XX_REPEAT_MIN		50ul	/* Fastest repeat period */
+#define DEL_BTN_XX_CHORD			100ul	/* Window to join a chord */
+
+#if (DEL_BTN_XX_LONG <= DEL_BTN_XX_CHORD)
+#error "DEL_BTN_XX_CHORD must end before the long press"
+#endif
+
+#define SENSOR_PORT_QTY_MAX			4ul		/* GPIOA..GPIOD */
+
+/* EXTI lines 5..15, the ones served by EXTI9_5 and EXTI15_10 */
+#define SENSOR_EXTI_9_5_LINES		0x03E0u
+#define SENSOR_EXTI_15_10_LINES		0xFC00u
+#define SENSOR_EXTI_IRQ_PRIORITY	1
+
+/* TIM2 paces the DMA sampling, 2 samples per tick; a buffer outlasts a
+ * tickless sleep (APP_TICKLESS_MAX_TICKS) */
+#define SENSOR_DMA_TIM				TIM2
+#define SENSOR_DMA_TIM_TICK_HZ		1000000ul
+#define SENSOR_DMA_SAMPLE_HZ		2000ul
+#define SENSOR_DMA_MASK				(SENSOR_DMA_SAMPLES - 1)
+
+#if (0 != (SENSOR_DMA_SAMPLES & SENSOR_DMA_MASK))
+#error "SENSOR_DMA_SAMPLES must be a power of two"
+#endif
+
 /********************** internal data declaration ****************************/
 const task_sensor_cfg_t task_sensor_cfg_list[] = {
 	{ID_BTN_ENT,  BTN_ENT_PORT,  BTN_ENT_PIN,  BTN_ENT_PRESSED, DEL_BTN_XX_MAX,
-	 EV_MEN_ENT_IDLE,  EV_MEN_ENT_ACTIVE},
+	 EV_MEN_ENT_IDLE,  EV_MEN_ENT_ACTIVE,
+	 DEL_BTN_XX_MIN,  EV_MEN_ENT_IDLE,  DEL_BTN_XX_MIN,  DEL_BTN_XX_MIN,  EV_MEN_ENT_IDLE},
 	{ID_BTN_NEX,  BTN_NEX_PORT,  BTN_NEX_PIN,  BTN_NEX_PRESSED, DEL_BTN_XX_MAX,
-	 EV_MEN_NEX_IDLE,  EV_MEN_NEX_ACTIVE},
+	 EV_MEN_NEX_IDLE,  EV_MEN_NEX_ACTIVE,
+	 DEL_BTN_XX_LONG, EV_MEN_NEX_REPEAT, DEL_BTN_XX_REPEAT_MAX, DEL_BTN_XX_REPEAT_MIN, EV_MEN_NEX_REPEAT},
 	{ID_BTN_ESC,  BTN_ESC_PORT,  BTN_ESC_PIN,  BTN_ESC_PRESSED, DEL_BTN_XX_MAX,
-	 EV_MEN_ESC_IDLE,  EV_MEN_ESC_ACTIVE}
+	 EV_MEN_ESC_IDLE,  EV_MEN_ESC_ACTIVE,
+	 DEL_BTN_XX_LONG, EV_MEN_ESC_LONG,   DEL_BTN_XX_MIN,  DEL_BTN_XX_MIN,  EV_MEN_ESC_IDLE}
 };
 
 #define SENSOR_CFG_QTY	(sizeof(task_sensor_cfg_list)/sizeof(task_sensor_cfg_t))
 
-task_sensor_dta_t task_sensor_dta_list[] = {
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP}
+const task_sensor_chord_cfg_t task_sensor_chord_cfg_list[] = {
+	{(1ul << ID_BTN_ENT) | (1ul << ID_BTN_ESC),	EV_MEN_ENT_ESC_CHORD}
+};
+
+#define SENSOR_CHORD_QTY	(sizeof(task_sensor_chord_cfg_list)/sizeof(task_sensor_chord_cfg_t))
+
+#if (1 == SENSOR_SAMPLE_DMA)
+/* TIM2 requests on DMA1: update on channel 2, CC3 (matching at 0, so once
+ * per period too) on channel 1. Ports not listed are read by the task */
+const task_sensor_dma_cfg_t task_sensor_dma_cfg_list[] = {
+	{GPIOA,	DMA1_Channel2,	TIM_DIER_UDE},
+	{GPIOB,	DMA1_Channel1,	TIM_DIER_CC3DE}
 };
 
-#define SENSOR_DTA_QTY	(sizeof(task_sensor_dta_list)/sizeof(task_sensor_dta_t))
+#define SENSOR_DMA_CFG_QTY	(sizeof(task_sensor_dma_cfg_list)/sizeof(task_sensor_dma_cfg_t))
+#endif
+
+/* Hold timers, indexed like task_sensor_cfg_list */
+task_sensor_hold_t task_sensor_hold_list[SENSOR_CFG_QTY];
+uint32_t task_sensor_holding;		/* Buttons whose hold timer runs */
+uint32_t task_sensor_pressed;		/* Debounced, 1 << task_sensor_id_t */
+uint32_t task_sensor_chord_done;	/* Chords emitted, until a release */
+uint32_t task_sensor_chord_members;	/* Buttons of any chord, 1 << task_sensor_id_t */
+uint32_t task_sensor_withheld;		/* Buttons whose down waits for a chord */
+
+/* One entry per GPIO port in use, filled by task_sensor_init() */
+task_sensor_dta_t task_sensor_dta_list[SENSOR_PORT_QTY_MAX];
+uint32_t task_sensor_port_qty;
+
+/* EXTI lines owned by the buttons, and the ones that saw an edge */
+uint16_t task_sensor_exti_lines;
+volatile uint16_t task_sensor_exti_pending;
 
 /********************** internal functions declaration ***********************/
 void task_sensor_statechart(void);
+bool task_sensor_port_sample(task_sensor_dta_t *p_task_sensor_dta, uint16_t *p_sample);
+void task_sensor_port_debounce(task_sensor_dta_t *p_task_sensor_dta, uint16_t sample);
+void task_sensor_dma_init(void);
+void task_sensor_exti_init(const task_sensor_cfg_t *p_task_sensor_cfg, task_sensor_dta_t *p_task_sensor_dta);
+void task_sensor_edge(uint32_t index, bool pressed);
+void task_sensor_hold_update(void);
+void task_sensor_chord_update(void);
 
 /********************** internal data definition *****************************/
 const char *p_task_sensor 		= "Task Sensor (Sensor Statechart)";
@@ -93,9 +160,10 @@ volatile uint32_t g_task_sensor_tick_cnt;
 void task_sensor_init(void *parameters)
 {
 	uint32_t index;
+	uint32_t port;
+	uint32_t chord;
+	const task_sensor_cfg_t *p_task_sensor_cfg;
 	task_sensor_dta_t *p_task_sensor_dta;
-	task_sensor_st_t state;
-	task_sensor_ev_t event;
 
 	/* Print out: Task Initialized */
 	LOGGER_INFO(" ");
@@ -106,23 +174,85 @@ void task_sensor_init(void *parameters)
 	g_task_sensor_cnt = G_TASK_SEN_CNT_INIT;
 	LOGGER_INFO("   %s = %lu", GET_NAME(g_task_sensor_cnt), g_task_sensor_cnt);
 
-	for (index = 0; SENSOR_DTA_QTY > index; index++)
+	/* Group the buttons by port, all released */
+	task_sensor_port_qty = 0;
+	task_sensor_exti_lines = 0;
+	task_sensor_exti_pending = 0;
+	memset(task_sensor_dta_list, 0, sizeof(task_sensor_dta_list));
+
+	task_sensor_holding = 0;
+	task_sensor_pressed = 0;
+	task_sensor_chord_done = 0;
+	task_sensor_withheld = 0;
+
+	task_sensor_chord_members = 0;
+	for (chord = 0; SENSOR_CHORD_QTY > chord; chord++)
+	{
+		task_sensor_chord_members |= task_sensor_chord_cfg_list[chord].buttons;
+	}
+
+	for (index = 0; SENSOR_CFG_QTY > index; index++)
 	{
+		p_task_sensor_cfg = &task_sensor_cfg_list[index];
+
+		for (port = 0; task_sensor_port_qty > port; port++)
+		{
+			if (p_task_sensor_cfg->gpio_port == task_sensor_dta_list[port].gpio_port)
+			{
+				break;
+			}
+		}
+		if (SENSOR_PORT_QTY_MAX <= port)
+		{
+			LOGGER_INFO("   %s: too many ports, button %lu ignored", GET_NAME(task_sensor_init), index);
+			continue;
+		}
+		if (task_sensor_port_qty == port)
+		{
+			task_sensor_port_qty++;
+		}
+
 		/* Update Task Sensor Data Pointer */
-		p_task_sensor_dta = &task_sensor_dta_list[index];
+		p_task_sensor_dta = &task_sensor_dta_list[port];
+		p_task_sensor_dta->gpio_port = p_task_sensor_cfg->gpio_port;
+		p_task_sensor_dta->mask |= p_task_sensor_cfg->pin;
+
+		if (GPIO_PIN_RESET == p_task_sensor_cfg->pressed)
+		{
+			p_task_sensor_dta->inverted |= p_task_sensor_cfg->pin;
+		}
+
+		debounce_tick_max_set(p_task_sensor_dta->tick_max, SENSOR_COUNT_BITS,
+							  p_task_sensor_cfg->pin, p_task_sensor_cfg->tick_max);
 
-		/* Init & Print out: Index & Task execution FSM */
-		state = ST_BTN_XX_UP;
-		p_task_sensor_dta->state = state;
+#if (0 == SENSOR_SAMPLE_DMA)
+		task_sensor_exti_init(p_task_sensor_cfg, p_task_sensor_dta);
+#endif
+	}
 
-		event = EV_BTN_XX_UP;
-		p_task_sensor_dta->event = event;
+#if (1 == SENSOR_SAMPLE_DMA)
+	task_sensor_dma_init();
+#endif
 
+	if (0 != (task_sensor_exti_lines & SENSOR_EXTI_9_5_LINES))
+	{
+		HAL_NVIC_SetPriority(EXTI9_5_IRQn, SENSOR_EXTI_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+	}
+	if (0 != (task_sensor_exti_lines & SENSOR_EXTI_15_10_LINES))
+	{
+		HAL_NVIC_SetPriority(EXTI15_10_IRQn, SENSOR_EXTI_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+	}
+
+	for (port = 0; task_sensor_port_qty > port; port++)
+	{
 		LOGGER_INFO(" ");
-		LOGGER_INFO("   %s = %lu   %s = %lu   %s = %lu",
-				    GET_NAME(index), index,
-					GET_NAME(state), (uint32_t)state,
-					GET_NAME(event), (uint32_t)event);
+		LOGGER_INFO("   %s = %lu   %s = 0x%04lx   %s = 0x%04lx   %s = 0x%04lx",
+				    GET_NAME(port), port,
+					GET_NAME(mask), (uint32_t)task_sensor_dta_list[port].mask,
+					GET_NAME(exti), (uint32_t)task_sensor_dta_list[port].exti,
+					GET_NAME(state), (uint32_t)task_sensor_dta_list[port].state);
 	}
 }
 
@@ -132,6 +262,7 @@ void task_sensor_update(void *parameters)
 
 	/* Protect shared resource */
 	__asm("CPSID i");	/* disable interrupts */
+	/* One release per call, app_update() applies the overrun policy */
     if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
     {
 		/* Update Tick Counter */
@@ -140,117 +271,394 @@ void task_sensor_update(void *parameters)
     }
     __asm("CPSIE i");	/* enable interrupts */
 
-    while (b_time_update_required)
+    if (b_time_update_required)
     {
 		/* Update Task Counter */
 		g_task_sensor_cnt++;
 
 		/* Run Task Sensor Statechart */
     	task_sensor_statechart();
+    }
+}
 
-    	/* Protect shared resource */
-		__asm("CPSID i");	/* disable interrupts */
-		if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
+/* True when no debounce or hold timer is running: held buttons wake the
+ * task by EXTI on release, polled pins are sampled on the next release */
+bool task_sensor_idle(void)
+{
+	uint32_t port;
+
+	if ((0 != task_sensor_holding) || (0 != task_sensor_withheld))
+	{
+		return false;
+	}
+
+	for (port = 0; task_sensor_port_qty > port; port++)
+	{
+		if (0 != (task_sensor_exti_pending & task_sensor_dta_list[port].exti))
 		{
-			/* Update Tick Counter */
-			g_task_sensor_tick_cnt--;
-			b_time_update_required = true;
+			return false;
 		}
-		else
+		if (true == debounce_counting(task_sensor_dta_list[port].count, SENSOR_COUNT_BITS))
 		{
-			b_time_update_required = false;
+			return false;
 		}
-		__asm("CPSIE i");	/* enable interrupts */
-    }
+	}
+	return true;
+}
+
+/* Called from EXTI9_5_IRQHandler() and EXTI15_10_IRQHandler() */
+void task_sensor_exti_irq_handler(void)
+{
+	uint16_t lines = (uint16_t)__HAL_GPIO_EXTI_GET_IT(task_sensor_exti_lines);
+
+	__HAL_GPIO_EXTI_CLEAR_IT(lines);
+	task_sensor_exti_pending |= lines;
 }
 
 void task_sensor_statechart(void)
+{
+	uint32_t port;
+	uint16_t pending;
+	uint16_t sample;
+	task_sensor_dta_t *p_task_sensor_dta;
+
+	for (port = 0; task_sensor_port_qty > port; port++)
+	{
+		p_task_sensor_dta = &task_sensor_dta_list[port];
+
+		/* Consumed before the IDR read, a later edge arms the port again */
+		__asm("CPSID i");	/* disable interrupts */
+		pending = task_sensor_exti_pending & p_task_sensor_dta->exti;
+		task_sensor_exti_pending &= (uint16_t)~pending;
+		__asm("CPSIE i");	/* enable interrupts */
+
+		if ((0 == pending) && (p_task_sensor_dta->mask == p_task_sensor_dta->exti)
+			&& (false == debounce_counting(p_task_sensor_dta->count, SENSOR_COUNT_BITS)))
+		{
+			continue;
+		}
+
+		if (true == task_sensor_port_sample(p_task_sensor_dta, &sample))
+		{
+			task_sensor_port_debounce(p_task_sensor_dta, sample);
+		}
+	}
+
+	if (0 != task_sensor_withheld)
+	{
+		task_sensor_chord_update();
+	}
+
+	if (0 != task_sensor_holding)
+	{
+		task_sensor_hold_update();
+	}
+}
+
+/* Both edges of the pin raise its EXTI line, unless that line is out of
+ * reach or already owned by a pin of another port: then it stays polled */
+void task_sensor_exti_init(const task_sensor_cfg_t *p_task_sensor_cfg, task_sensor_dta_t *p_task_sensor_dta)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	uint16_t line = p_task_sensor_cfg->pin;
+
+	if ((0 == (line & (SENSOR_EXTI_9_5_LINES | SENSOR_EXTI_15_10_LINES))) || (0 != (line & task_sensor_exti_lines)))
+	{
+		LOGGER_INFO("   %s: EXTI line 0x%04lx not available, button %lu is polled",
+					GET_NAME(task_sensor_exti_init), (uint32_t)line, (uint32_t)p_task_sensor_cfg->identifier);
+		return;
+	}
+
+	GPIO_InitStruct.Pin = line;
+	GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+	GPIO_InitStruct.Pull = (GPIO_PIN_RESET == p_task_sensor_cfg->pressed) ? GPIO_PULLUP : GPIO_PULLDOWN;
+	HAL_GPIO_Init(p_task_sensor_cfg->gpio_port, &GPIO_InitStruct);
+	__HAL_GPIO_EXTI_CLEAR_IT(line);
+
+	task_sensor_exti_lines |= line;
+	p_task_sensor_dta->exti |= line;
+}
+
+/* Sample of the port for this release, 1 = pressed; false if there is none */
+bool task_sensor_port_sample(task_sensor_dta_t *p_task_sensor_dta, uint16_t *p_sample)
+{
+#if (1 == SENSOR_SAMPLE_DMA)
+	uint32_t head;
+	uint16_t all;
+	uint16_t any;
+	uint16_t sample;
+
+	if (NULL != p_task_sensor_dta->dma)
+	{
+		head = (SENSOR_DMA_SAMPLES - p_task_sensor_dta->dma->CNDTR) & SENSOR_DMA_MASK;
+		if (head == p_task_sensor_dta->tail)
+		{
+			return false;
+		}
+
+		/* Lanes down in every sample, and lanes down in any */
+		all = p_task_sensor_dta->mask;
+		any = 0;
+		while (head != p_task_sensor_dta->tail)
+		{
+			sample = (p_task_sensor_dta->sample[p_task_sensor_dta->tail] ^ p_task_sensor_dta->inverted) &
+					 p_task_sensor_dta->mask;
+			all &= sample;
+			any |= sample;
+			p_task_sensor_dta->tail = (p_task_sensor_dta->tail + 1) & SENSOR_DMA_MASK;
+		}
+
+		/* A lane that bounced within the batch keeps the debounced state */
+		*p_sample = all | (any & p_task_sensor_dta->state);
+		return true;
+	}
+#endif
+
+	/* One IDR read for every button of the port */
+	*p_sample = (uint16_t)((p_task_sensor_dta->gpio_port->IDR ^ p_task_sensor_dta->inverted) & p_task_sensor_dta->mask);
+	return true;
+}
+
+void task_sensor_port_debounce(task_sensor_dta_t *p_task_sensor_dta, uint16_t sample)
 {
 	uint32_t index;
+	uint16_t match;
+	uint16_t pressed;
+	uint16_t released;
 	const task_sensor_cfg_t *p_task_sensor_cfg;
-	task_sensor_dta_t *p_task_sensor_dta;
 
-	for (index = 0; SENSOR_DTA_QTY > index; index++)
+	match = debounce_update(&p_task_sensor_dta->state, p_task_sensor_dta->count,
+							p_task_sensor_dta->tick_max, SENSOR_COUNT_BITS, sample);
+	if (0 == match)
+	{
+		return;
+	}
+
+	pressed  = match & p_task_sensor_dta->state;
+	released = match & (uint16_t)~p_task_sensor_dta->state;
+
+	/* Edges are rare, map them back to the buttons only then */
+	for (index = 0; SENSOR_CFG_QTY > index; index++)
 	{
-		/* Update Task Sensor Configuration & Data Pointer */
 		p_task_sensor_cfg = &task_sensor_cfg_list[index];
-		p_task_sensor_dta = &task_sensor_dta_list[index];
 
-		if (p_task_sensor_cfg->pressed == HAL_GPIO_ReadPin(p_task_sensor_cfg->gpio_port, p_task_sensor_cfg->pin))
+		if (p_task_sensor_cfg->gpio_port != p_task_sensor_dta->gpio_port)
 		{
-			p_task_sensor_dta->event =	EV_BTN_XX_DOWN;
+			continue;
 		}
-		else
+		if (0 != (pressed & p_task_sensor_cfg->pin))
+		{
+			task_sensor_edge(index, true);
+		}
+		else if (0 != (released & p_task_sensor_cfg->pin))
 		{
-			p_task_sensor_dta->event =	EV_BTN_XX_UP;
+			task_sensor_edge(index, false);
 		}
+	}
+}
+
+#if (1 == SENSOR_SAMPLE_DMA)
+/* Circular DMA from each listed port IDR, one transfer per TIM2 period */
+void task_sensor_dma_init(void)
+{
+	uint32_t timer_clock = HAL_RCC_GetPCLK1Freq();
+	uint32_t request = 0;
+	uint32_t port;
+	uint32_t index;
+	task_sensor_dta_t *p_task_sensor_dta;
+
+	/* APB1 timers run at twice PCLK1 when the APB1 prescaler is not 1 */
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+	{
+		timer_clock *= 2;
+	}
+
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	SENSOR_DMA_TIM->CR1 = 0;
+	SENSOR_DMA_TIM->PSC = (timer_clock / SENSOR_DMA_TIM_TICK_HZ) - 1;
+	SENSOR_DMA_TIM->ARR = (SENSOR_DMA_TIM_TICK_HZ / SENSOR_DMA_SAMPLE_HZ) - 1;
+	SENSOR_DMA_TIM->CCR3 = 0;
+	SENSOR_DMA_TIM->EGR = TIM_EGR_UG;
+	SENSOR_DMA_TIM->SR = 0;
 
-		switch (p_task_sensor_dta->state)
+	for (port = 0; task_sensor_port_qty > port; port++)
+	{
+		p_task_sensor_dta = &task_sensor_dta_list[port];
+		p_task_sensor_dta->dma = NULL;
+
+		for (index = 0; SENSOR_DMA_CFG_QTY > index; index++)
 		{
-			case ST_BTN_XX_UP:
+			if (task_sensor_dma_cfg_list[index].gpio_port != p_task_sensor_dta->gpio_port)
+			{
+				continue;
+			}
+
+			p_task_sensor_dta->dma = task_sensor_dma_cfg_list[index].dma;
+			p_task_sensor_dta->tail = 0;
+
+			/* Word reads of IDR (GPIO takes no 16-bit access) packed into the
+			 * 16-bit ring, no interrupt: the task polls CNDTR */
+			p_task_sensor_dta->dma->CCR = 0;
+			p_task_sensor_dta->dma->CPAR = (uint32_t)&p_task_sensor_dta->gpio_port->IDR;
+			p_task_sensor_dta->dma->CMAR = (uint32_t)p_task_sensor_dta->sample;
+			p_task_sensor_dta->dma->CNDTR = SENSOR_DMA_SAMPLES;
+			p_task_sensor_dta->dma->CCR = DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_EN;
+
+			request |= task_sensor_dma_cfg_list[index].request;
+			break;
+		}
 
-				if (EV_BTN_XX_DOWN == p_task_sensor_dta->event)
-				{
-					p_task_sensor_dta->tick = p_task_sensor_cfg->tick_max;
-					p_task_sensor_dta->state = ST_BTN_XX_FALLING;
-				}
+		if (NULL == p_task_sensor_dta->dma)
+		{
+			LOGGER_INFO("   %s: no DMA request for port %lu, it is read by the task",
+						GET_NAME(task_sensor_dma_init), port);
+		}
+	}
 
-				break;
+	SENSOR_DMA_TIM->DIER = request;
+	SENSOR_DMA_TIM->CR1 = TIM_CR1_CEN;
+}
+#endif
 
-			case ST_BTN_XX_FALLING:
+/* Debounced edge of button 'index': up/down signal, hold timer and chords.
+ * The down of a chord button is withheld for DEL_BTN_XX_CHORD ticks, so a
+ * chord does not act on its first button alone */
+void task_sensor_edge(uint32_t index, bool pressed)
+{
+	uint32_t chord;
+	uint32_t buttons;
+	uint32_t member;
+	const task_sensor_cfg_t *p_task_sensor_cfg = &task_sensor_cfg_list[index];
+	task_sensor_hold_t *p_task_sensor_hold = &task_sensor_hold_list[index];
 
-				p_task_sensor_dta->tick--;
-				if (DEL_BTN_XX_MIN == p_task_sensor_dta->tick)
-				{
-					if (EV_BTN_XX_DOWN == p_task_sensor_dta->event)
-					{
-						put_event_task_menu(p_task_sensor_cfg->signal_down);
-						p_task_sensor_dta->state = ST_BTN_XX_DOWN;
-					}
-					else
-					{
-						p_task_sensor_dta->state = ST_BTN_XX_UP;
-					}
-				}
+	if (true == pressed)
+	{
+		task_sensor_pressed |= (1ul << p_task_sensor_cfg->identifier);
 
-				break;
+		if (0 != (task_sensor_chord_members & (1ul << p_task_sensor_cfg->identifier)))
+		{
+			p_task_sensor_hold->chord = (uint16_t)DEL_BTN_XX_CHORD;
+			task_sensor_withheld |= (1ul << index);
+		}
+		else
+		{
+			put_event_task_menu(p_task_sensor_cfg->signal_down);
+		}
 
-			case ST_BTN_XX_DOWN:
+		if (DEL_BTN_XX_MIN != p_task_sensor_cfg->tick_long)
+		{
+			p_task_sensor_hold->tick = (uint16_t)p_task_sensor_cfg->tick_long;
+			p_task_sensor_hold->period = 0;
+			task_sensor_holding |= (1ul << index);
+		}
+	}
+	else
+	{
+		if (0 != (task_sensor_withheld & (1ul << index)))
+		{
+			/* Released within the window, no chord: a plain click */
+			put_event_task_menu(p_task_sensor_cfg->signal_down);
+			task_sensor_withheld &= ~(1ul << index);
+		}
+		put_event_task_menu(p_task_sensor_cfg->signal_up);
+		task_sensor_pressed &= ~(1ul << p_task_sensor_cfg->identifier);
+		task_sensor_holding &= ~(1ul << index);
+	}
+
+	for (chord = 0; SENSOR_CHORD_QTY > chord; chord++)
+	{
+		buttons = task_sensor_chord_cfg_list[chord].buttons;
 
-				if (EV_BTN_XX_UP == p_task_sensor_dta->event)
+		if (buttons != (task_sensor_pressed & buttons))
+		{
+			task_sensor_chord_done &= ~(1ul << chord);
+		}
+		else if (0 == (task_sensor_chord_done & (1ul << chord)))
+		{
+			/* The chord replaces the downs its buttons still withhold */
+			for (member = 0; SENSOR_CFG_QTY > member; member++)
+			{
+				if (0 != (buttons & (1ul << task_sensor_cfg_list[member].identifier)))
 				{
-					p_task_sensor_dta->state = ST_BTN_XX_RISING;
-					p_task_sensor_dta->tick = p_task_sensor_cfg->tick_max;
+					task_sensor_withheld &= ~(1ul << member);
 				}
+			}
+			put_event_task_menu(task_sensor_chord_cfg_list[chord].signal);
+			task_sensor_chord_done |= (1ul << chord);
+		}
+	}
+}
 
-				break;
+/* One tick of every chord window, a down still withheld at its end is emitted */
+void task_sensor_chord_update(void)
+{
+	uint32_t withheld = task_sensor_withheld;
+	uint32_t index;
 
-			case ST_BTN_XX_RISING:
+	while (0 != withheld)
+	{
+		index = __CLZ(__RBIT(withheld));
+		withheld &= withheld - 1;
 
-				p_task_sensor_dta->tick--;
-				if (DEL_BTN_XX_MIN == p_task_sensor_dta->tick)
-				{
-					if (EV_BTN_XX_UP == p_task_sensor_dta->event)
-					{
-						put_event_task_menu(p_task_sensor_cfg->signal_up);
-						p_task_sensor_dta->state = ST_BTN_XX_UP;
-					}
-					else
-					{
-						p_task_sensor_dta->state = ST_BTN_XX_DOWN;
-					}
-				}
+		if (0 != --task_sensor_hold_list[index].chord)
+		{
+			continue;
+		}
 
-				break;
+		put_event_task_menu(task_sensor_cfg_list[index].signal_down);
+		task_sensor_withheld &= ~(1ul << index);
+	}
+}
 
-			default:
+/* One tick of every running hold timer, only held buttons are visited */
+void task_sensor_hold_update(void)
+{
+	uint32_t holding = task_sensor_holding;
+	uint32_t index;
+	const task_sensor_cfg_t *p_task_sensor_cfg;
+	task_sensor_hold_t *p_task_sensor_hold;
 
-				p_task_sensor_dta->tick  = DEL_BTN_XX_MIN;
-				p_task_sensor_dta->state = ST_BTN_XX_UP;
-				p_task_sensor_dta->event = EV_BTN_XX_UP;
+	while (0 != holding)
+	{
+		index = __CLZ(__RBIT(holding));
+		holding &= holding - 1;
 
-				break;
+		p_task_sensor_hold = &task_sensor_hold_list[index];
+		if (0 != --p_task_sensor_hold->tick)
+		{
+			continue;
+		}
+
+		p_task_sensor_cfg = &task_sensor_cfg_list[index];
+		if (0 == p_task_sensor_hold->period)
+		{
+			put_event_task_menu(p_task_sensor_cfg->signal_long);
+			p_task_sensor_hold->period = (uint16_t)p_task_sensor_cfg->tick_repeat_max;
+		}
+		else
+		{
+			put_event_task_menu(p_task_sensor_cfg->signal_repeat);
+
+			/* Accelerate: a quarter shorter each time, down to the minimum */
+			p_task_sensor_hold->period -= p_task_sensor_hold->period >> 2;
+			if (p_task_sensor_cfg->tick_repeat_min > p_task_sensor_hold->period)
+			{
+				p_task_sensor_hold->period = (uint16_t)p_task_sensor_cfg->tick_repeat_min;
+			}
+		}
+
+		if (0 == p_task_sensor_hold->period)
+		{
+			/* Long press only: done until the next press */
+			task_sensor_holding &= ~(1ul << index);
+		}
+		else
+		{
+			p_task_sensor_hold->tick = p_task_sensor_hold->period;
 		}
 	}
 }
+
 /********************** end of file ******************************************/
@@ -0,0 +1,522 @@
+/*
+ * @file   : display_bench.c
+ * @brief  : Host-side HD44780 emulator and LCD throughput benchmark
+ *
+ * Builds app/src/display.c unchanged against host GPIO and TIM4 stand-ins
+ * (main.h in this directory). The TIM4 write engine is played in simulated
+ * microseconds: each timer period is added to the clock, the update ISR is
+ * called and its BSRR writes are applied to ODR. Every EN falling edge
+ * latches RS and D7..D0 (D7..D4 in 4-bit mode) into an emulated HD44780
+ * with DDRAM, CGRAM, address counter and instruction execution times.
+ *
+ * Each scenario reports simulated bus time, EN strobes and the part of the
+ * bus time spent in post-strobe delays, checks the emulated DDRAM against
+ * the text written and fails when a strobe lands on a busy controller or a
+ * budget is exceeded.
+ *
+ * Usage:
+ *   make check
+ *
+ * displayFlush() stops at a full ring, a scenario bigger than the ring
+ * flushes again after draining, as the next display release would.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "board.h"
+#include "display.h"
+
+/********************** macros and definitions *******************************/
+#define BENCH_DDRAM_SIZE        128
+#define BENCH_CGRAM_SIZE        64
+
+#define BENCH_EXEC_US           37ul
+#define BENCH_EXEC_CLEAR_US     1520ul
+#define BENCH_EXEC_WAKEUP1_US   4100ul
+#define BENCH_EXEC_WAKEUP2_US   100ul
+
+typedef struct {
+    bool fourBit;
+    bool nibblePending;
+    uint8_t nibbleHigh;
+    bool cgramSelected;
+    uint8_t ac;
+    uint8_t ddram[BENCH_DDRAM_SIZE];
+    uint8_t cgram[BENCH_CGRAM_SIZE];
+    bool displayOn;
+    uint32_t functionSets;
+    uint64_t busyUntil;
+} benchLcd_t;
+
+typedef struct {
+    uint64_t busUs;         // Timer periods from the first strobe to idle
+    uint64_t strobeUs;      // Periods spent with EN high
+    uint64_t delayUs;       // Periods spent waiting after EN dropped
+    uint32_t strobes;
+    uint32_t violations;    // Strobes while the controller was busy
+} benchStats_t;
+
+typedef enum {
+    BENCH_INIT,
+    BENCH_FULL_SCREEN,
+    BENCH_SCREEN_CHANGE,
+    BENCH_UNCHANGED,
+    BENCH_STATUS_LINE,
+    BENCH_SCREEN_WRITE,
+    BENCH_BAR_UPLOAD,
+    BENCH_BAR_STEP,
+    BENCH_GLYPHS_SCREEN,
+    BENCH_QTY
+} benchScenario_t;
+
+// Budgets per connection, indexed by displayConnection_t (4-bit, 8-bit).
+// They are the figures of the current driver: lower them when it improves
+typedef struct {
+    const char *name;
+    uint32_t calls;         // displayCharPositionWrite()/displayStringWrite() calls
+    uint32_t maxStrobes[2];
+    uint32_t maxBusUs[2];
+} benchBudget_t;
+
+/********************** internal data definition *****************************/
+GPIO_TypeDef benchGpioA, benchGpioB, benchGpioC, benchGpioD;
+TIM_TypeDef benchTim4;
+RCC_TypeDef benchRcc;
+AFIO_TypeDef benchAfio;
+I2C_TypeDef benchI2c1;
+DMA_TypeDef benchDma1;
+DMA_Channel_TypeDef benchDma1Channel6;
+DWT_Type benchDwt;
+
+uint32_t SystemCoreClock = 64000000ul;
+volatile uint32_t g_dwt_cyccnt_high;
+volatile uint32_t g_dwt_cyccnt_last;
+
+static GPIO_TypeDef * const benchPorts[] = { GPIOA, GPIOB, GPIOC, GPIOD };
+
+static const struct {
+    GPIO_TypeDef *port;
+    uint16_t pin;
+} benchDataPins[8] = {
+    { DISPLAY_D0_PORT, DISPLAY_D0_PIN }, { DISPLAY_D1_PORT, DISPLAY_D1_PIN },
+    { DISPLAY_D2_PORT, DISPLAY_D2_PIN }, { DISPLAY_D3_PORT, DISPLAY_D3_PIN },
+    { DISPLAY_D4_PORT, DISPLAY_D4_PIN }, { DISPLAY_D5_PORT, DISPLAY_D5_PIN },
+    { DISPLAY_D6_PORT, DISPLAY_D6_PIN }, { DISPLAY_D7_PORT, DISPLAY_D7_PIN },
+};
+
+static const uint8_t benchRowAddress[4] = { 0x00, 0x40, 0x14, 0x54 };
+
+static const benchBudget_t benchBudgets[BENCH_QTY] = {
+    { "init sequence",         0, {  14,   8 }, { 7411, 7351 } },
+    { "full screen",           8, { 102,  51 }, { 2246, 2042 } },
+    { "screen change",         8, {  94,  47 }, { 2070, 1882 } },
+    { "unchanged rewrite",    16, {   0,   0 }, {    0,    0 } },
+    { "status line update",    2, {  12,   6 }, {  266,  242 } },
+    { "whole screen write",    1, { 128,  64 }, { 2818, 2562 } },
+    { "bar, glyph upload",     1, {  80,  40 }, { 1762, 1602 } },
+    { "bar, one step",         1, {   4,   2 }, {   90,   82 } },
+    { "glyphs + whole screen", 1, { 306, 153 }, { 6736, 6122 } },
+};
+
+static uint64_t benchNowUs;
+static bool benchEnable;
+static benchLcd_t benchLcd;
+static benchStats_t benchStats;
+static uint32_t benchFailures;
+
+/********************** HAL stand-ins ****************************************/
+uint32_t HAL_GetTick( void )
+{
+    return (uint32_t)( benchNowUs / 1000 );
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq( void )
+{
+    return SystemCoreClock / 2;
+}
+
+void HAL_NVIC_SetPriority( IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority )
+{
+}
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn )
+{
+}
+
+void HAL_GPIO_Init( GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init )
+{
+}
+
+void HAL_GPIO_WritePin( GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState )
+{
+    if ( PinState == GPIO_PIN_SET ) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+/********************** HD44780 emulator *************************************/
+static void benchLcdReset( void )
+{
+    memset( &benchLcd, 0, sizeof(benchLcd) );
+    memset( benchLcd.ddram, 0xA5, sizeof(benchLcd.ddram) );     // Garbage until cleared
+}
+
+static void benchLcdAddressIncrement( void )
+{
+    if ( benchLcd.cgramSelected ) {
+        benchLcd.ac = ( benchLcd.ac + 1 ) & ( BENCH_CGRAM_SIZE - 1 );
+    } else if ( benchLcd.ac == 0x27 ) {
+        benchLcd.ac = 0x40;
+    } else if ( benchLcd.ac == 0x67 ) {
+        benchLcd.ac = 0x00;
+    } else {
+        benchLcd.ac++;
+    }
+}
+
+static void benchLcdExecute( bool rs, uint8_t value )
+{
+    uint32_t execUs = BENCH_EXEC_US;
+
+    if ( benchNowUs < benchLcd.busyUntil ) {
+        benchStats.violations++;
+    }
+
+    if ( rs ) {
+        if ( benchLcd.cgramSelected ) {
+            benchLcd.cgram[benchLcd.ac] = value & 0x1F;
+        } else {
+            benchLcd.ddram[benchLcd.ac] = value;
+        }
+        benchLcdAddressIncrement();
+    } else if ( value & 0x80 ) {
+        benchLcd.ac = value & 0x7F;
+        benchLcd.cgramSelected = false;
+    } else if ( value & 0x40 ) {
+        benchLcd.ac = value & 0x3F;
+        benchLcd.cgramSelected = true;
+    } else if ( value & 0x20 ) {
+        // The wake-up function sets take longer than the rest
+        if ( benchLcd.functionSets == 0 ) {
+            execUs = BENCH_EXEC_WAKEUP1_US;
+        } else if ( benchLcd.functionSets == 1 ) {
+            execUs = BENCH_EXEC_WAKEUP2_US;
+        }
+        benchLcd.functionSets++;
+        benchLcd.fourBit = !( value & 0x10 );
+    } else if ( value & 0x10 ) {
+        // Cursor or display shift, not used by the driver
+    } else if ( value & 0x08 ) {
+        benchLcd.displayOn = ( value & 0x04 ) != 0;
+    } else if ( value & 0x04 ) {
+        // Entry mode: the driver only uses increment, no shift
+    } else if ( value & 0x02 ) {
+        benchLcd.ac = 0;
+        benchLcd.cgramSelected = false;
+        execUs = BENCH_EXEC_CLEAR_US;
+    } else if ( value & 0x01 ) {
+        memset( benchLcd.ddram, ' ', sizeof(benchLcd.ddram) );
+        benchLcd.ac = 0;
+        benchLcd.cgramSelected = false;
+        execUs = BENCH_EXEC_CLEAR_US;
+    }
+
+    benchLcd.busyUntil = benchNowUs + execUs;
+}
+
+// EN falling edge: the controller latches RS and the data pins
+static void benchLcdLatch( void )
+{
+    bool rs = ( DISPLAY_RS_PORT->ODR & DISPLAY_RS_PIN ) != 0;
+    uint8_t bus = 0;
+    uint8_t bit;
+
+    benchStats.strobes++;
+
+    for ( bit = 0; bit < 8; bit++ ) {
+        if ( benchDataPins[bit].port->ODR & benchDataPins[bit].pin ) {
+            bus |= 1 << bit;
+        }
+    }
+
+    if ( !benchLcd.fourBit ) {
+        benchLcdExecute( rs, bus );
+        return;
+    }
+
+    if ( !benchLcd.nibblePending ) {
+        // The first nibble only needs the interface, not the controller
+        benchLcd.nibbleHigh = bus & 0xF0;
+        benchLcd.nibblePending = true;
+        return;
+    }
+    benchLcd.nibblePending = false;
+    benchLcdExecute( rs, benchLcd.nibbleHigh | ( bus >> 4 ) );
+}
+
+static char benchLcdCell( uint8_t row, uint8_t column )
+{
+    return (char)benchLcd.ddram[benchRowAddress[row] + column];
+}
+
+/********************** timer and GPIO playback ******************************/
+static void benchPortsApply( void )
+{
+    uint32_t i, bsrr;
+    bool enable;
+
+    for ( i = 0; i < sizeof(benchPorts) / sizeof(benchPorts[0]); i++ ) {
+        bsrr = benchPorts[i]->BSRR;
+        if ( bsrr ) {
+            benchPorts[i]->ODR = ( benchPorts[i]->ODR & ~( bsrr >> 16 ) ) | ( bsrr & 0xFFFF );
+            benchPorts[i]->BSRR = 0;
+        }
+    }
+
+    enable = ( DISPLAY_EN_PORT->ODR & DISPLAY_EN_PIN ) != 0;
+    if ( benchEnable && !enable ) {
+        benchLcdLatch();
+    }
+    benchEnable = enable;
+}
+
+// Plays the one-pulse timer until the write engine goes idle
+static void benchDrain( void )
+{
+    uint32_t period;
+
+    benchPortsApply();
+
+    while ( TIM4->CR1 & TIM_CR1_CEN ) {
+        period = TIM4->ARR + 1;
+        benchNowUs += period;
+        benchStats.busUs += period;
+        if ( benchEnable ) {
+            benchStats.strobeUs += period;
+        } else {
+            benchStats.delayUs += period;
+        }
+
+        TIM4->CR1 &= ~TIM_CR1_CEN;
+        TIM4->SR |= TIM_SR_UIF;
+        displayTimerIrqHandler();
+        benchPortsApply();
+    }
+}
+
+/********************** scenarios ********************************************/
+static void benchStatsReset( void )
+{
+    memset( &benchStats, 0, sizeof(benchStats) );
+}
+
+static void benchExpectRow( uint8_t row, const char *text )
+{
+    uint8_t column;
+
+    for ( column = 0; column < 20; column++ ) {
+        if ( benchLcdCell( row, column ) != text[column] ) {
+            printf( "  FAIL: row %u column %u is 0x%02X, expected '%c'\n", row, column,
+                    (uint8_t)benchLcdCell( row, column ), text[column] );
+            benchFailures++;
+            return;
+        }
+    }
+}
+
+static void benchReport( displayConnection_t connection, benchScenario_t scenario )
+{
+    const benchBudget_t *budget = &benchBudgets[scenario];
+    bool fail = ( benchStats.violations != 0 ) ||
+                ( benchStats.strobes > budget->maxStrobes[connection] ) ||
+                ( benchStats.busUs > budget->maxBusUs[connection] );
+
+    printf( "  %-22s bus %5llu us  strobes %4lu  delay %5llu us  per call %5llu us  %s\n",
+            budget->name,
+            (unsigned long long)benchStats.busUs, (unsigned long)benchStats.strobes,
+            (unsigned long long)benchStats.delayUs,
+            (unsigned long long)( budget->calls ? benchStats.busUs / budget->calls : 0 ),
+            fail ? "FAIL" : "ok" );
+
+    if ( benchStats.violations ) {
+        printf( "  FAIL: %lu strobes while the controller was busy\n",
+                (unsigned long)benchStats.violations );
+    }
+    if ( benchStats.strobes > budget->maxStrobes[connection] ) {
+        printf( "  FAIL: budget is %lu strobes\n", (unsigned long)budget->maxStrobes[connection] );
+    }
+    if ( benchStats.busUs > budget->maxBusUs[connection] ) {
+        printf( "  FAIL: budget is %lu us\n", (unsigned long)budget->maxBusUs[connection] );
+    }
+    if ( fail ) {
+        benchFailures++;
+    }
+}
+
+static void benchRowsWrite( const char * const rows[4] )
+{
+    uint8_t row;
+
+    for ( row = 0; row < 4; row++ ) {
+        displayCharPositionWrite( 0, row );
+        displayStringWrite( rows[row] );
+    }
+}
+
+static void benchConnection( displayConnection_t connection, const char *name )
+{
+    static const char * const screenA[4] = {
+        "Motor 1: OFF,0,R    ", "Motor 2: OFF,0,R    ",
+        "Enter/Next/Escape   ", "                    " };
+    static const char * const screenB[4] = {
+        "Motor 1: OFF,0,R    ", "Next -> Motor 2     ",
+        "Enter to edit       ", "Escape to return    " };
+    static const char blank[] = "                    ";
+    uint8_t glyph[DISPLAY_GLYPH_ROWS];
+    uint32_t flushes;
+    uint32_t i;
+
+    printf( "%s\n", name );
+
+    for ( i = 0; i < sizeof(benchPorts) / sizeof(benchPorts[0]); i++ ) {
+        memset( benchPorts[i], 0, sizeof(GPIO_TypeDef) );
+    }
+    memset( &benchTim4, 0, sizeof(benchTim4) );
+    benchNowUs = 0;
+    benchEnable = false;
+    benchLcdReset();
+
+    // Bring-up: displayUpdate() once per millisecond, as a task would
+    benchStatsReset();
+    displayInit( connection );
+    for ( i = 0; ( i < 1000 ) && !displayReady(); i++ ) {
+        benchNowUs += 1000;
+        displayUpdate();
+        benchDrain();
+    }
+    if ( !displayReady() || !benchLcd.displayOn || benchLcd.fourBit !=
+         ( connection == DISPLAY_CONNECTION_GPIO_4BITS ) ) {
+        printf( "  FAIL: not ready after %lu ms\n", (unsigned long)i );
+        benchFailures++;
+    }
+    for ( i = 0; i < 4; i++ ) {
+        benchExpectRow( i, blank );
+    }
+    benchReport( connection, BENCH_INIT );
+
+    benchStatsReset();
+    benchRowsWrite( screenA );
+    displayFlush();
+    benchDrain();
+    for ( i = 0; i < 4; i++ ) {
+        benchExpectRow( i, screenA[i] );
+    }
+    benchReport( connection, BENCH_FULL_SCREEN );
+
+    benchStatsReset();
+    benchRowsWrite( screenB );
+    displayFlush();
+    benchDrain();
+    for ( i = 0; i < 4; i++ ) {
+        benchExpectRow( i, screenB[i] );
+    }
+    benchReport( connection, BENCH_SCREEN_CHANGE );
+
+    benchStatsReset();
+    benchRowsWrite( screenB );
+    benchRowsWrite( screenB );
+    displayFlush();
+    benchDrain();
+    benchReport( connection, BENCH_UNCHANGED );
+
+    benchStatsReset();
+    displayCharPositionWrite( 0, 0 );
+    displayStringWrite( "Motor 1:  ON,5,R    " );
+    displayFlush();
+    benchDrain();
+    benchExpectRow( 0, "Motor 1:  ON,5,R    " );
+    benchReport( connection, BENCH_STATUS_LINE );
+
+    // Every cell changes: two address commands, lines 1-3 and 2-4 run on
+    benchStatsReset();
+    displayScreenWrite( "Speed 1234567890 abc"
+                        "Power ON   Spin Left"
+                        "01234567890123456789"
+                        "Escape to return ..." );
+    displayFlush();
+    benchDrain();
+    benchExpectRow( 0, "Speed 1234567890 abc" );
+    benchExpectRow( 1, "Power ON   Spin Left" );
+    benchExpectRow( 2, "01234567890123456789" );
+    benchExpectRow( 3, "Escape to return ..." );
+    benchReport( connection, BENCH_SCREEN_WRITE );
+
+    // 5 of 9 over 3 cells is 8 columns: a full cell and a 3-column glyph
+    benchStatsReset();
+    displayBarWrite( 17, 0, 3, 5, 9 );
+    displayFlush();
+    benchDrain();
+    if ( ( benchLcd.cgram[0] != 0x10 ) || ( benchLcd.cgram[3 * 8] != 0x1E ) ||
+         ( benchLcdCell( 0, 17 ) != (char)0xFF ) ||
+         ( benchLcdCell( 0, 18 ) != DISPLAY_GLYPH_CHAR( 2 ) ) ||
+         ( benchLcdCell( 0, 19 ) != ' ' ) ) {
+        printf( "  FAIL: bar glyphs or cells\n" );
+        benchFailures++;
+    }
+    benchReport( connection, BENCH_BAR_UPLOAD );
+
+    // 6 of 9 is 10 columns: only the second cell changes
+    benchStatsReset();
+    displayBarWrite( 17, 0, 3, 6, 9 );
+    displayFlush();
+    benchDrain();
+    if ( benchLcdCell( 0, 18 ) != (char)0xFF ) {
+        printf( "  FAIL: bar cell is 0x%02X\n", (uint8_t)benchLcdCell( 0, 18 ) );
+        benchFailures++;
+    }
+    benchReport( connection, BENCH_BAR_STEP );
+
+    // Every glyph and every cell: on a 4-bit bus more than the ring holds,
+    // so the first flush stops short and the next release finishes the frame
+    benchStatsReset();
+    for ( i = 0; i < DISPLAY_GLYPH_QTY; i++ ) {
+        memset( glyph, 0x11 + i, sizeof(glyph) );
+        displayGlyphLoad( i, glyph );
+    }
+    displayScreenWrite( "Glyphs and a screen "
+                        "in more than one    "
+                        "flush, none of them "
+                        "waits for the ring  " );
+    for ( flushes = 0; ( flushes < 4 ) && displayDirty(); flushes++ ) {
+        displayFlush();
+        benchDrain();
+    }
+    if ( ( flushes != ( ( connection == DISPLAY_CONNECTION_GPIO_4BITS ) ? 2 : 1 ) ) || displayDirty() ||
+         ( benchLcd.cgram[7 * 8] != ( 0x11 + 7 ) ) ) {
+        printf( "  FAIL: %lu flushes, dirty %d, glyph 7 is 0x%02X\n", (unsigned long)flushes,
+                displayDirty(), benchLcd.cgram[7 * 8] );
+        benchFailures++;
+    }
+    benchExpectRow( 0, "Glyphs and a screen " );
+    benchExpectRow( 1, "in more than one    " );
+    benchExpectRow( 2, "flush, none of them " );
+    benchExpectRow( 3, "waits for the ring  " );
+    benchReport( connection, BENCH_GLYPHS_SCREEN );
+}
+
+int main( void )
+{
+    benchConnection( DISPLAY_CONNECTION_GPIO_4BITS, "GPIO 4-bit" );
+    benchConnection( DISPLAY_CONNECTION_GPIO_8BITS, "GPIO 8-bit" );
+
+    if ( benchFailures ) {
+        printf( "%lu failure(s)\n", (unsigned long)benchFailures );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
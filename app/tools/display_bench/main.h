@@ -0,0 +1,52 @@
+/*
+ * @file   : main.h
+ * @brief  : Host stand-in for Core/Inc/main.h (display_bench only)
+ *
+ * Pulls in the real main.h, so the pin labels and register layouts are the
+ * firmware's, then points every peripheral display.c touches at a plain
+ * struct in host memory. display_bench.c applies BSRR writes to ODR and
+ * plays the timer after each call into the driver.
+ */
+
+#ifndef DISPLAY_BENCH_MAIN_H_
+#define DISPLAY_BENCH_MAIN_H_
+
+#include "../../../Core/Inc/main.h"
+
+/* Cortex-M only instructions */
+#define __asm(...)
+
+extern GPIO_TypeDef benchGpioA, benchGpioB, benchGpioC, benchGpioD;
+extern TIM_TypeDef benchTim4;
+extern RCC_TypeDef benchRcc;
+extern AFIO_TypeDef benchAfio;
+extern I2C_TypeDef benchI2c1;
+extern DMA_TypeDef benchDma1;
+extern DMA_Channel_TypeDef benchDma1Channel6;
+extern DWT_Type benchDwt;
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef TIM4
+#undef RCC
+#undef AFIO
+#undef I2C1
+#undef DMA1
+#undef DMA1_Channel6
+#undef DWT
+
+#define GPIOA           ( &benchGpioA )
+#define GPIOB           ( &benchGpioB )
+#define GPIOC           ( &benchGpioC )
+#define GPIOD           ( &benchGpioD )
+#define TIM4            ( &benchTim4 )
+#define RCC             ( &benchRcc )
+#define AFIO            ( &benchAfio )
+#define I2C1            ( &benchI2c1 )
+#define DMA1            ( &benchDma1 )
+#define DMA1_Channel6   ( &benchDma1Channel6 )
+#define DWT             ( &benchDwt )
+
+#endif /* DISPLAY_BENCH_MAIN_H_ */
@@ -0,0 +1,101 @@
+/*
+ * @file   : logger_trace_check.c
+ * @brief  : Host round trip of LOGGER_TRACE records through the decoder
+ *
+ * Builds app/src/logger.c unchanged against a host DWT and USART2 (main.h
+ * in this directory). A text line and a few LOGGER_TRACE records, with
+ * fixed DWT timestamps, go through the logger ring; the USART2 ISR is then
+ * called until the ring is empty and every byte it writes to DR is saved
+ * to the capture file, as a serial capture of the board would be.
+ *
+ * The format strings land in the .trace_fmt section of this executable, so
+ * ../logger_trace_decode.py decodes the capture with it as the ELF.
+ *
+ * Usage:
+ *   make check
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "logger.h"
+
+/* Written by the USART2 ISR: anything above a byte means no write */
+#define CHECK_DR_IDLE			(0x100)
+
+DWT_Type checkDwt;
+USART_TypeDef check_usart2;
+UART_HandleTypeDef huart2 = { .Instance = &check_usart2 };
+
+static const char *p_check_name = "task_sensor";
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+}
+
+/* USART2 empties the ring, one byte per TXE interrupt */
+static uint32_t check_drain(FILE *capture)
+{
+	uint32_t bytes = 0;
+
+	check_usart2.SR = USART_SR_TXE;
+	while (0 != (check_usart2.CR1 & USART_CR1_TXEIE))
+	{
+		check_usart2.DR = CHECK_DR_IDLE;
+		logger_uart_irq_handler();
+		if (CHECK_DR_IDLE != check_usart2.DR)
+		{
+			fputc((int)check_usart2.DR, capture);
+			bytes++;
+		}
+	}
+	return bytes;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *capture;
+	uint32_t bytes;
+
+	if (2 != argc)
+	{
+		fprintf(stderr, "usage: %s capture.bin\n", argv[0]);
+		return 2;
+	}
+
+	/* Text and records share the ring, as on the board */
+	LOGGER_INFO("logger trace check");
+
+	/* The stats dump of app_stats_dump_update() */
+	checkDwt.CYCCNT = 64000ul;
+	LOGGER_TRACE(" app cnt %lu overrun %lu skip %lu", (uint32_t)10000, (uint32_t)2, (uint32_t)7);
+	checkDwt.CYCCNT = 128000ul;
+	LOGGER_TRACE(" idle [%%o] %lu sleeps %lu tickless %lu", (uint32_t)912, (uint32_t)9120, (uint32_t)0);
+	checkDwt.CYCCNT = 192000ul;
+	LOGGER_TRACE("  task %lu hist[%lu] %lu %lu %lu %lu", (uint32_t)0, (uint32_t)4,
+				 (uint32_t)9000, (uint32_t)990, (uint32_t)10, (uint32_t)0);
+
+	/* Strings in flash, signed, hex, char and no argument at all */
+	checkDwt.CYCCNT = 256000ul;
+	LOGGER_TRACE("%s %ld 0x%08lx %c", (uint32_t)p_check_name, (uint32_t)-42, (uint32_t)0xBEEF, (uint32_t)'k');
+	checkDwt.CYCCNT = 0xFFFFFFFFul;
+	LOGGER_TRACE("no arguments");
+
+	capture = fopen(argv[1], "wb");
+	if (NULL == capture)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+	bytes = check_drain(capture);
+	fclose(capture);
+
+	printf("logger_trace_check: %lu bytes captured, %lu dropped\n",
+		   (unsigned long)bytes, (unsigned long)logger_dropped);
+	return (0 == logger_dropped) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+/*
+ * @file   : main.h
+ * @brief  : Host stand-in for Core/Inc/main.h (logger_trace_check only)
+ *
+ * Pulls in the real main.h, so the register layouts are the firmware's,
+ * then points DWT at a plain struct in host memory. USART2 is reached
+ * through huart2.Instance, which logger_trace_check.c sets up.
+ */
+
+#ifndef LOGGER_TRACE_CHECK_MAIN_H_
+#define LOGGER_TRACE_CHECK_MAIN_H_
+
+#include "../../../Core/Inc/main.h"
+
+/* Cortex-M only instructions */
+#define __asm(...)
+
+extern DWT_Type checkDwt;
+
+#undef DWT
+
+#define DWT             ( &checkDwt )
+
+#endif /* LOGGER_TRACE_CHECK_MAIN_H_ */
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Sebastian Bedin <sebabedin@gmail.com>.
+# All rights reserved.
+#
+# @file   : logger_trace_decode.py
+# @brief  : Host-side decoder for LOGGER_TRACE binary records (logger.h)
+#
+# Reads the USART2 log stream (a capture file or stdin), prints text as it
+# arrives and rebuilds every LOGGER_TRACE record from the format strings
+# kept in the .trace_fmt section of the firmware ELF.
+#
+# Usage:
+#   stty -F /dev/ttyACM0 115200 raw
+#   python3 logger_trace_decode.py Debug/tdse-tp3_04-interactive_menu.elf < /dev/ttyACM0
+#   python3 logger_trace_decode.py firmware.elf capture.bin --clock 64000000
+
+import argparse
+import re
+import struct
+import sys
+
+TRACE_SYNC = 0x1E
+TRACE_HEADER_LEN = 10
+TRACE_FMT_SECTION = ".trace_fmt"
+
+C_FORMAT = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|t|j)?([diouxXcsp%])")
+
+
+class Elf:
+    """Minimal little-endian ELF reader: section data by name or address.
+    ELF32 for the firmware, ELF64 for the host check (tools/logger_trace_check)."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] not in (1, 2):
+            raise ValueError("%s is not an ELF file" % path)
+        if self.data[4] == 1:
+            (shoff,) = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+            layout = "<IIIIIIIIII"
+        else:
+            (shoff,) = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3A)
+            layout = "<IIQQQQIIQQ"
+        headers = []
+        for index in range(shnum):
+            fields = struct.unpack_from(layout, self.data, shoff + index * shentsize)
+            headers.append(fields)
+        strtab = headers[shstrndx]
+        self.sections = []
+        for name, stype, flags, addr, offset, size, _, _, _, _ in headers:
+            end = self.data.index(b"\0", strtab[4] + name)
+            sname = self.data[strtab[4] + name:end].decode()
+            nobits = (stype == 8)
+            self.sections.append((sname, flags, addr, offset, size, nobits))
+
+    def section(self, name):
+        for sname, _, addr, offset, size, nobits in self.sections:
+            if sname == name and not nobits:
+                return addr, self.data[offset:offset + size]
+        raise KeyError("section %s not found" % name)
+
+    def string_at(self, address):
+        """C string at a target address in an allocated (SHF_ALLOC) section."""
+        for _, flags, addr, offset, size, nobits in self.sections:
+            if (flags & 0x2) and not nobits and addr <= address < addr + size:
+                start = offset + address - addr
+                return self.data[start:self.data.index(b"\0", start)].decode(errors="replace")
+        return "<0x%08x>" % address
+
+
+def c_printf(fmt, args, elf):
+    """Format raw 32-bit args with a C printf format string."""
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        spec = "%" + flags + width + ("." + precision if precision else "")
+        if conv in "di":
+            return (spec + "d") % (value - (1 << 32) if value & 0x80000000 else value)
+        if conv == "s":
+            return (spec + "s") % elf.string_at(value)
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return (spec + "s") % ("0x%08x" % value)
+        return (spec + conv) % value
+
+    return C_FORMAT.sub(convert, fmt)
+
+
+def decode(stream, elf, clock_hz, out):
+    fmt_base, fmt_data = elf.section(TRACE_FMT_SECTION)
+    buffer = b""
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            break
+        buffer += chunk
+        while buffer:
+            if buffer[0] != TRACE_SYNC:
+                out.write(chr(buffer[0]))
+                buffer = buffer[1:]
+                continue
+            if len(buffer) < 2:
+                break
+            length = TRACE_HEADER_LEN + 4 * buffer[1]
+            if len(buffer) < length:
+                break
+            nargs = buffer[1]
+            fmt_id, timestamp = struct.unpack_from("<II", buffer, 2)
+            args = struct.unpack_from("<%dI" % nargs, buffer, TRACE_HEADER_LEN)
+            buffer = buffer[length:]
+            offset = fmt_id - fmt_base
+            if 0 <= offset < len(fmt_data):
+                end = fmt_data.index(b"\0", offset)
+                text = c_printf(fmt_data[offset:end].decode(errors="replace"), args, elf)
+            else:
+                text = "<unknown format id 0x%08x> %s" % (fmt_id, " ".join("0x%08x" % a for a in args))
+            if clock_hz:
+                out.write("[trace %12.3f us] %s\n" % (timestamp * 1e6 / clock_hz, text))
+            else:
+                out.write("[trace %10u] %s\n" % (timestamp, text))
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode LOGGER_TRACE records from a log stream")
+    parser.add_argument("elf", help="firmware ELF with the .trace_fmt section")
+    parser.add_argument("capture", nargs="?", help="raw capture file (default: stdin)")
+    parser.add_argument("--clock", type=int, default=0,
+                        help="core clock in Hz, to print timestamps in microseconds")
+    options = parser.parse_args()
+
+    elf = Elf(options.elf)
+    if options.capture:
+        with open(options.capture, "rb") as stream:
+            decode(stream, elf, options.clock, sys.stdout)
+    else:
+        decode(sys.stdin.buffer, elf, options.clock, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()